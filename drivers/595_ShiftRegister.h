@@ -48,6 +48,10 @@ extern "C" {
      * 
      * @pre ShiftReg595_Initialize routine should must be called first
      * 
+     * @note The bits are unrolled (util/bitbang.h). __595ShiftRegister_Delay
+     * runs after the rising edge of SH_CP only (the high time), the low time
+     * is the code of the next bit.
+     * 
      * @author Jose Guerra Carmenate
      * @version 1.0
      * @date 15/02/2019
@@ -65,6 +69,10 @@ extern "C" {
      * 
      * @pre ShiftReg595_Initialize routine should must be called first
      * 
+     * @note The bits are unrolled (util/bitbang.h). __595ShiftRegister_Delay
+     * runs after the rising edge of SH_CP only (the high time), the low time
+     * is the code of the next bit.
+     * 
      * @author Jose Guerra Carmenate
      * @version 1.0
      * @date 15/02/2019
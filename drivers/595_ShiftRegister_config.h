@@ -128,7 +128,8 @@
 
 /**
  * @brief 
- * This macro define the High time for clock signals.
+ * This macro define the High time for clock signals (executed after the
+ * rising edge of SH_CP only).
  * <p><b>Example</b></p>
  * <code>
  * // High Time = 500 us delay                          <br>
@@ -11,6 +11,7 @@
 #include <xc.h>
 #include "595_ShiftRegister.h"
 #include "595_ShiftRegister_config.h"
+#include "../util/bitbang.h"
 
 #define DATA    __595ShiftRegister_DATA
 #define CLK     __595ShiftRegister_CLOCK
@@ -21,23 +22,6 @@
 #define STROB_Dir __595ShiftRegister_STROBE_Dir   
 
 
-/**
- * @brief 
- * This macro generate one pulse clock on SH_CP input
- *
- * @pre ShiftReg595_Initialize routine must be called first
- *
- * @author Jose Guerra Carmenate
- * @version 1.0
- * @date 15/02/2019
-*/
-#define clock() {                       \
-            CLK = 1;                    \
-            __595ShiftRegister_Delay;   \
-            CLK = 0;                    \
-        }
-
-
 /**
  * @brief 
  * This macro generate one pulse clock on ST_CP input
@@ -64,27 +48,15 @@ inline void ShiftReg595_Initialize(){
 
 /* See 595_ShiftRegister.h for use details */
 void ShiftReg595_SendByteLSBFirst( uint8_t byte ){
-    uint8_t l = 7;
-    while( l != 255 ){          // for each bit
-        DATA = (byte) & 0x01;   // put bit on DATA
-        clock();                // send it
-        byte >>= 1;             // right-shift byte to right
-        l--;
-    }
+    // the 8 bits unrolled (see util/bitbang.h), delay on the high time only
+    BITBANG_SEND_LSB_FIRST( DATA, CLK, __595ShiftRegister_Delay, , byte );
     strobe();                   // update data to 595 storage register
 }
 
 /* See 595_ShiftRegister.h for use details */
 void ShiftReg595_SendByteMSBFirst( uint8_t byte ){
-    uint8_t l = 7;
-    while( l != 255 ){                                  // for each bit
-        byte = (byte<<1) | ( (byte&0x80)?0x01:0x00 );   // cyclic left-shift
-
-        DATA = byte & 0x01;                             // put bit on DATA
-        clock();                                        // send it
-        l--;
-    }
-    strobe();                                           // update data to 595 storage register
+    BITBANG_SEND_MSB_FIRST( DATA, CLK, __595ShiftRegister_Delay, , byte );
+    strobe();                   // update data to 595 storage register
 
 }
 
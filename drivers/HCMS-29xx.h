@@ -41,6 +41,8 @@
 #include <xc.h>
 #include <stdint.h>
 #include "HCMS-29xx_config.h"
+#include "../util/num2str.h"
+#include "../util/pt.h"
 
 
 /******************************************************************************
@@ -114,6 +116,37 @@ extern "C" {
      * </code>
      **/
     void LedDisplay_Initialize(uint8_t _displayLen, char* _displayBuffer, uint8_t _bufferSize);
+
+#if __HCMS_29xx_COMPILE_LedDisplay_InitializeTask == 1
+    /**
+     * @Summary
+     *  Non blocking version of LedDisplay_Initialize
+     * 
+     * @Description
+     *  Protothread task (see util/pt.h and util/sched.h) that perform the
+     * same inicialization, but the 10ms reset pulse is done with
+     * SCHED_DELAY_MS instead of __delay_ms.
+     *  Call it (with the same arguments) until it returns PT_ENDED.
+     * 
+     * @Preconditions
+     *  SCHED_Tick must be called every 1ms.
+     * 
+     * @Param
+     *  - pt: task control block, initialized with PT_INIT.
+     *  - See LedDisplay_Initialize for the other params.
+     * 
+     * @Returns 
+     *  PT_WAITING while the task is running, PT_ENDED when it finished.
+     * 
+     * @Example
+     * <code>
+     * while( LedDisplay_InitializeTask( &ptDisplay, 8, __bufferForDisplay, 16 ) != PT_ENDED ){
+     *     // other work
+     * }
+     * </code>
+     **/
+    uint8_t LedDisplay_InitializeTask( pt_t *pt, uint8_t _displayLen, char* _displayBuffer, uint8_t _bufferSize );
+#endif
     
     /**
      * @Summary
@@ -607,6 +640,42 @@ extern "C" {
     inline void LedDisplay_PrintUInt16( uint16_t x, uint8_t b );
 #endif
     
+#if __HCMS_29xx_COMPILE_LedDisplay_PrintUInt16Field == 1
+    /**
+     * @Summary
+     *  Print a 16-bits unsigned integer number on a fixed width field.
+     * 
+     * @Description
+     *  This routine take a number (and a base) and print it on the HCMS-29xx 
+     * Display using always 'width' characters, so the previous value is 
+     * overwritten without clear the display.
+     * 
+     * @Preconditions
+     *  LedDisplay_Initialize routine need be called before.
+     * 
+     * @Param
+     *   - x: integer that will be printed on the HCMS-29xx Display.
+     *   - b: base used for print the integer
+     *   - width: field width. OR with NUM2STR_ALIGN_LEFT for left alignment
+     *   - pad: character used for fill the field (Ej: ' ' or '0')
+     * 
+     * @Returns 
+     *   None
+     * 
+     * @Comments
+     *  See uint2str_w on num2str.h
+     * 
+     * @Example
+     * <code>
+     * ...
+     * LedDisplay_Initialize( 8, __display_buffer, 16 );
+     * LedDisplay_SetCursor( 4 );
+     * LedDisplay_PrintUInt16Field( 99, 10, 4, ' ' ); // print "  99"
+     * </code>
+     **/
+    inline void LedDisplay_PrintUInt16Field( uint16_t x, uint8_t b, uint8_t width, char pad );
+#endif
+
 #if __HCMS_29xx_COMPILE_LedDisplay_PrintInt16 == 1
     
     /**
@@ -672,6 +741,70 @@ extern "C" {
      **/
     inline void LedDisplay_PrintFloat( float x, uint8_t afterpoint );
 #endif
+
+#if __HCMS_29xx_COMPILE_LedDisplay_PrintFixed == 1
+    /**
+     * @Summary
+     *  Print a fixed point number on the HCMS-29xx Display.
+     * 
+     * @Description
+     *  This routine take an integer and the number of decimals and print 
+     * x * 10^-decimals on the HCMS-29xx Display. 
+     * 
+     * @Preconditions
+     *  LedDisplay_Initialize routine need be called before.
+     * 
+     * @Param
+     *   - x: fixed point number that will be printed on the HCMS-29xx Display.
+     *   - decimals: amount of decimal digits of x
+     * 
+     * @Returns 
+     *   None
+     * 
+     * @Comments
+     *  Use this routine instead of LedDisplay_PrintFloat for avoid the 
+     * float library (it need much program memory on small devices).
+     * 
+     * @Example
+     * <code>
+     * ...
+     * LedDisplay_Initialize( 8, __display_buffer, 16 );
+     * LedDisplay_SetBrightness( 12 );
+     * LedDisplay_PrintFixed( 1250, 2 ); // print 12.50
+     * </code>
+     **/
+    inline void LedDisplay_PrintFixed( int32_t x, uint8_t decimals );
+#endif
+
+#if __HCMS_29xx_COMPILE_LedDisplay_Sink == 1
+    /**
+     * @Summary
+     *  Character sink of the HCMS-29xx Display buffer.
+     * 
+     * @Description
+     *  Character sink (see num2str.h) that store every character on the 
+     * display buffer at the cursor position and advance the cursor. The 
+     * characters that exceed the buffer size are discarded.
+     * 
+     * @Preconditions
+     *  LedDisplay_Initialize routine need be called before.
+     * 
+     * @Comments
+     *  The dot register is not loaded by the sink, call 
+     * LedDisplay_LoadDotRegister after the whole text was stored (one load for
+     * several numbers).
+     * 
+     * @Example
+     * <code>
+     * ...
+     * LedDisplay_SetCursor( 0 );
+     * ulong2sink( volts, 10, 3, ' ', &LedDisplay_Sink );
+     * fix2sink( amps, 2, 5, ' ', &LedDisplay_Sink );
+     * LedDisplay_LoadDotRegister();
+     * </code>
+     **/
+    extern const num2str_sink_t LedDisplay_Sink;
+#endif
     
 #ifdef	__cplusplus
 }
@@ -158,8 +158,12 @@
 
 #define __HCMS_29xx_COMPILE_LedDisplay_GetCursor 	0 	// Habilitar/Deshabilitar la Compilacion de la rutina LedDisplay_GetCursor
 #define __HCMS_29xx_COMPILE_LedDisplay_PrintUInt16 	1 	// Habilitar/Deshabilitar la Compilacion de la rutina LedDisplay_PrintUInt16
+#define __HCMS_29xx_COMPILE_LedDisplay_PrintUInt16Field 0 // Habilitar/Deshabilitar la Compilacion de la rutina LedDisplay_PrintUInt16Field
 #define __HCMS_29xx_COMPILE_LedDisplay_PrintInt16 	0	// Habilitar/Deshabilitar la Compilacion de la rutina LedDisplay_PrintInt16
 #define __HCMS_29xx_COMPILE_LedDisplay_PrintFloat 	0	// Habilitar/Deshabilitar la Compilacion de la rutina LedDisplay_PrintFloat
+#define __HCMS_29xx_COMPILE_LedDisplay_PrintFixed 	0	// Habilitar/Deshabilitar la Compilacion de la rutina LedDisplay_PrintFixed
+#define __HCMS_29xx_COMPILE_LedDisplay_Sink 		0	// Habilitar/Deshabilitar la Compilacion del sink LedDisplay_Sink
+#define __HCMS_29xx_COMPILE_LedDisplay_InitializeTask 0 // Habilitar/Deshabilitar la Compilacion de la rutina LedDisplay_InitializeTask
 
 
 
@@ -33,6 +33,10 @@
 
 #include "HCMS-29xx.h"
 #include "../util/num2str.h"
+#include "../util/sched.h"
+#include "../util/profile.h"
+#include "../util/trace.h"
+#include "../util/bitbang.h"
 
 #if HCMS_29xx_USE_FONT5X7==1
 
@@ -63,6 +67,12 @@
 #define RST_Dir _HCMS_29xx_DISPLAY_RST_Dir
 #endif
 
+#ifdef CLK_DELAY
+#define ledDisplay_ClkDelay CLK_DELAY
+#else
+#define ledDisplay_ClkDelay
+#endif
+
 /******************************************************************************
  ************************** Section: Local Vars *******************************
  ******************************************************************************/
@@ -76,6 +86,16 @@ static uint8_t cursorPosition;
 int8_t cursorShift;
 #endif
 
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+/**
+ * Send one byte on Din/CLK (MSB first, unrolled):
+ * static void ledDisplay_SendByte( uint8_t byte )
+ **/
+BITBANG_DEFINE( ledDisplay_SendByte, MSB_FIRST, Din, CLK, ledDisplay_ClkDelay, ledDisplay_ClkDelay )
+
 /******************************************************************************
  ********************* Section: HCMS-29xx Display APIs ************************
  ******************************************************************************/
@@ -87,17 +107,7 @@ void LedDisplay_LoadControlRegister( uint8_t controlWord ){
     //Enable display for write
     CE = 0u;
     //Data out (MSB first)
-    for( uint8_t j = 7u; j != 255u; j-- ){ //unitl overflow
-        Din = (controlWord>>j)&0x01u;
-        CLK = 1u;
-#ifdef CLK_DELAY
-        CLK_DELAY;
-#endif
-        CLK = 0u;
-#ifdef CLK_DELAY
-        CLK_DELAY;
-#endif
-    }
+    ledDisplay_SendByte( controlWord );
     //Release the display and load register
     CE = 1u;
 }
@@ -120,6 +130,7 @@ void LedDisplay_LoadAllControlRegisters( uint8_t controlWord ){
 
 /** See header for more information **/
 void LedDisplay_LoadDotRegister() {
+    PROFILE_BEGIN( PROFILE_ID_LED_DISPLAY_LOAD );
     
     for( int8_t displayPos = 0; displayPos < displayLen; displayPos++ ){
 #if __HCMS_29xx_COMPILE_LedDisplay_Scroll==1
@@ -132,10 +143,15 @@ void LedDisplay_LoadDotRegister() {
 #endif
     }
     CE = 1;
+    
+    PROFILE_END( PROFILE_ID_LED_DISPLAY_LOAD );
+    TRACE_RECORD( TRACE_ID_DISPLAY, displayLen );
 }
 
-/** See header for more information **/
-void LedDisplay_Initialize(uint8_t _displayLen, char* _displayBuffer, uint8_t _bufferSize){
+/**
+ * Store the display parameters and configure the pins as outputs
+ **/
+static void ledDisplay_Setup(uint8_t _displayLen, char* _displayBuffer, uint8_t _bufferSize){
     displayLen =  _displayLen;
     displayBuffer = _displayBuffer;
     bufferSize = _bufferSize;
@@ -148,7 +164,11 @@ void LedDisplay_Initialize(uint8_t _displayLen, char* _displayBuffer, uint8_t _b
     CE_Dir = 0u;
     CLK_Dir = 0u;
     RS_Dir = 0u;
-    
+}
+
+/** See header for more information **/
+void LedDisplay_Initialize(uint8_t _displayLen, char* _displayBuffer, uint8_t _bufferSize){
+    ledDisplay_Setup( _displayLen, _displayBuffer, _bufferSize );
     
 #ifdef RST
     //reset display
@@ -163,6 +183,27 @@ void LedDisplay_Initialize(uint8_t _displayLen, char* _displayBuffer, uint8_t _b
     LedDisplay_LoadAllControlRegisters( 0b01111111 );
 }
 
+#if __HCMS_29xx_COMPILE_LedDisplay_InitializeTask == 1
+/** See header for more information **/
+uint8_t LedDisplay_InitializeTask( pt_t *pt, uint8_t _displayLen, char* _displayBuffer, uint8_t _bufferSize ){
+    PT_BEGIN( pt );
+    ledDisplay_Setup( _displayLen, _displayBuffer, _bufferSize );
+    
+#ifdef RST
+    //reset display
+    RST_Dir = 0u;
+    RST = 0u;
+    SCHED_DELAY_MS( pt, 10u );
+    RST = 1u;
+#endif
+    // Fill the  display with spaces (' ')
+    LedDisplay_Clear();
+    // Set normal mode and maximum brightness for all displays
+    LedDisplay_LoadAllControlRegisters( 0b01111111 );
+    PT_END( pt );
+}
+#endif
+
 /** See header for more information **/
 void LedDisplay_Clear( void ){
 	cursorPosition = 0;
@@ -204,22 +245,9 @@ void LedDisplay_PutUserChar( const unsigned char *map ){
     CLK = 0;    // Not rising
     CE = 0;     // falling edge
     
-    // Write character to display
-    for( uint8_t i = 0; i < 5; i++ ){
-        unsigned char b = map[i];
-        // Send data (MSB first)
-        for( uint8_t j = 7; j != 255; j-- ){ 
-            Din = (b>>j)&0x01;
-            CLK = 1;
-#ifdef CLK_DELAY
-        CLK_DELAY;
-#endif            
-            CLK = 0;
-#ifdef CLK_DELAY
-        CLK_DELAY;
-#endif
-        }
-    }
+    // Write character to display (5 columns, MSB first)
+    for( uint8_t i = 0; i < 5; i++ )
+        ledDisplay_SendByte( map[i] );
 }
 
 /** See header for more information **/
@@ -251,6 +279,16 @@ inline void LedDisplay_PrintUInt16( uint16_t x, uint8_t _base ){
 }
 #endif
 
+#if __HCMS_29xx_COMPILE_LedDisplay_PrintUInt16Field == 1
+/** See header for more information **/
+inline void LedDisplay_PrintUInt16Field( uint16_t x, uint8_t _base, uint8_t width, char pad ){
+    //overwrite the field on the buffer (always 'width' characters)
+    cursorPosition += uint2str_w( x, _base, width, pad, displayBuffer+cursorPosition );
+    // load dot register from the buffer
+    LedDisplay_LoadDotRegister();
+}
+#endif
+
 #if __HCMS_29xx_COMPILE_LedDisplay_PrintInt16 == 1
 /** See header for more information **/
 inline void LedDisplay_PrintInt16( int16_t x, uint8_t _base ){
@@ -271,5 +309,26 @@ inline void LedDisplay_PrintFloat( float x, uint8_t afterpoint ){
 }
 #endif
 
+#if __HCMS_29xx_COMPILE_LedDisplay_PrintFixed == 1
+/** See header for more information **/
+inline void LedDisplay_PrintFixed( int32_t x, uint8_t decimals ){
+    //put the fixed point number on the buffer
+    cursorPosition += (uint8_t)fix2str( x, decimals, displayBuffer+cursorPosition );
+    // load dot register from the buffer
+    LedDisplay_LoadDotRegister();
+}
+#endif
+
+#if __HCMS_29xx_COMPILE_LedDisplay_Sink == 1
+static void ledDisplay_SinkPut( void *ctx, char c ){
+    (void)ctx;
+    if( cursorPosition < bufferSize )
+        displayBuffer[ cursorPosition++ ] = c;
+}
+
+/** See header for more information **/
+const num2str_sink_t LedDisplay_Sink = { ledDisplay_SinkPut, 0 };
+#endif
+
 #endif// if lite version
 
@@ -25,6 +25,7 @@
 #include <xc.h>
 #include <stddef.h>
 #include "../util/utils.h"
+#include "../util/profile.h"
 /******************************************************************************
  ************************** Section: Constants ********************************
  ******************************************************************************/
@@ -69,10 +70,12 @@ bool MCP4922_WriteData( MCP_DAC_SELECT adc,  uint16_t data ){
     if( ptr_dac == NULL )
         return false;
     
-    ptr_dac->command.upperByte &= 0x70;
-    ptr_dac->command.upperByte |= (uint8_t)adc | (uint8_t)MCP_OUTPUT_CONTROL_BUFFER_ENABLED;
-    ptr_dac->command.lowerByte = 0;
-    ptr_dac->command.cmd |= (data & 0x0FFF);
+    PROFILE_BEGIN( PROFILE_ID_MCP4922_WRITE );
+    // keep VREF and GAIN bits, replace DAC select, SHDN and data bits
+    BIT_InsertMask( ptr_dac->command.upperByte, 0x9Fu,
+                    (uint8_t)adc | (uint8_t)MCP_OUTPUT_CONTROL_BUFFER_ENABLED |
+                    BYTE_GetNibble( data, 2u ) );
+    ptr_dac->command.lowerByte = BYTE_GetByte( data, 0u );
     
     while( ptr_dac->IsBusy() );
     BIT_ClearBit( *(ptr_dac->SS_port), ptr_dac->SS_bit );
@@ -81,6 +84,7 @@ bool MCP4922_WriteData( MCP_DAC_SELECT adc,  uint16_t data ){
     ptr_dac->SendCommand( ptr_dac->command.lowerByte );
     while( (*(ptr_dac->IsBusy))() );
     BIT_SetBit( *(ptr_dac->SS_port), ptr_dac->SS_bit );
+    PROFILE_END( PROFILE_ID_MCP4922_WRITE );
     
     return true;
 }
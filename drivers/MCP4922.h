@@ -144,6 +144,16 @@ typedef enum{
 
   @Comment
  Severals MCP4922 can have the same SendByte and ISBusy routine.
+ When the bus is shared with devices on other modes, SendByte can select the
+ SPI mode of the DAC first (PIC16F887: SPI_Begin with a device without chip
+ select, it only reprograms the MSSP when the mode changed):
+    static const spi_device_t dacBus = SPI_DEVICE( NULL, 0, SPI_CLOCK_RATE_FOSC_DIV_4,
+                                                   SPI_CLOCK_POLARITY_IDLE_LOW,
+                                                   SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK,
+                                                   SPI_INPUT_SAMPLING_PHASE_IN_MIDDLE );
+    static void dacSend( uint8_t b ){ SPI_Begin( &dacBus ); SPI_WriteByte( b ); }
+    ...
+    one = MCP4922_MCP4922( &PORTB, 2, dacSend, SPI_IsBusy );
 
   @Example
     <code>
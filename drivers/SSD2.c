@@ -13,6 +13,8 @@
 
 #include <xc.h>
 #include "SSD2.h"
+#include "../util/utils.h"
+#include "../util/trace.h"
 
 const uint8_t _bcd_to_7seg[] = {
     //.gfedcba
@@ -28,6 +30,24 @@ const uint8_t _bcd_to_7seg[] = {
     0b01101111  // 9
 };
 
+/**
+ * @Descripcion
+ * Numeros 0-99 en BCD empaquetado (decenas en el nibble alto), evita las
+ * divisiones por 10 (el PIC no tiene divisor).
+ **/
+static const uint8_t _bin_to_bcd[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
+    0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+    0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+    0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99
+};
+
 /**
  * @Descripcion
  * Retorna un puntero al registro TRISx correscondiente
@@ -84,8 +104,9 @@ __bit SSD_Initialize( ssd_t *ssd, volatile uint8_t *__port ){
 void SSD_PrintNumber( ssd_t* ssd, uint8_t number ){
     if( number > 99u )                     // no se puede mostrar
         return;
-    ssd->digit1 = _bcd_to_7seg[number%10]; // digito decimal
-    ssd->digit0 = _bcd_to_7seg[number/10]; // digito decenas
+    number = _bin_to_bcd[number];           // dos digitos en una lectura
+    ssd->digit1 = _bcd_to_7seg[BYTE_GetNibble0to4(number)]; // digito decimal
+    ssd->digit0 = _bcd_to_7seg[BYTE_GetNibble4to8(number)]; // digito decenas
 }
 
 
@@ -104,4 +125,5 @@ inline void SSD_Mux( ssd_t *ssd ){
     
     x ^= 1;                         // cambia actual
    *(ssd->port) = port;             // escribir al puerto
+    TRACE_RECORD( TRACE_ID_DISPLAY, x );
 }
@@ -23,6 +23,8 @@
  ******************************************************************************/
 
 #include <stdint.h>
+#include "../util/num2str.h"
+#include "../util/pt.h"
 
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -299,6 +301,103 @@ void LCD_PrintChar( char c );
 */
 void LCD_PrintString( char *string );
 
+/**
+  @Summary
+    Non blocking versions of LCD_Initialize and LCD_PrintString
+
+  @Description
+    Protothread tasks (see util/pt.h and util/sched.h): the millisecond 
+  delays and the busy waits (without RW) are done with SCHED_DELAY_MS, so the
+  CPU is given to the other tasks instead of spinning on __delay_ms.
+    Call the task (with the same arguments) until it returns PT_ENDED.
+
+  @Preconditions
+    'LCD_Attach' must be called before. SCHED_Tick must be called every 1ms.
+    Only one LCD task can be running at time.
+
+  @Param
+	- pt: Task control block, initialized with PT_INIT.
+	
+	- lines, row: see LCD_Initialize.
+	
+	- str: string to print, it must not change until the task ends.
+	
+  @Returns
+    PT_WAITING while the task is running, PT_ENDED when it finished.
+
+  @Comment
+	Without RW every character waits two ticks (SCHED_DELAY_MS waits more than
+	1 ms, so 1 to 2 ms).
+  @Example
+    <code>
+     static pt_t ptLcd, ptChild;
+     static uint8_t lcdTask( void ){
+         PT_BEGIN( &ptLcd );
+         PT_SPAWN( &ptLcd, &ptChild, LCD_InitializeTask( &ptChild, 2, 16 ) );
+         PT_SPAWN( &ptLcd, &ptChild, LCD_PrintStringTask( &ptChild, "Hello" ) );
+         PT_END( &ptLcd );
+     }
+    </code>
+*/
+uint8_t LCD_InitializeTask( pt_t *pt, uint8_t lines, uint8_t row );
+uint8_t LCD_PrintStringTask( pt_t *pt, const char *str );
+
+/**
+  @Summary
+    LCD character sink
+
+  @Description
+    Character sink (see num2str.h) that prints every character on the LCD at
+  the current cursor position. Numbers are printed while they are converted,
+  no intermediate string is needed.
+
+  @Preconditions
+    'LCD_Initialize' must be called before.
+
+  @Comment
+    See LCD_PrintUInt, LCD_PrintInt and LCD_PrintFixed.
+  @Example
+    <code>
+     ulong2sink( rpm, 10, 5, ' ', &LCD_Sink );
+     FMT_Print( &LCD_Sink, fmtStatus, t, flags );
+    </code>
+*/
+extern const num2str_sink_t LCD_Sink;
+
+/**
+  @Summary
+    Print a number on LCD
+
+  @Description
+    Print x (decimal) on a field of 'width' characters right aligned and
+  filled with spaces (width 0: natural size). LCD_PrintFixed prints
+  x * 10^-decimals (see fix2str).
+
+  @Preconditions
+    'LCD_Initialize' must be called before.
+
+  @Param
+	- x: Number to print.
+	
+	- width: Field size (see num2str.h field routines).
+	
+  @Returns
+    Amount of characters printed
+
+  @Comment
+	None
+  @Example
+    <code>
+     LCD_PrintUInt( adc, 4 );         // " 512"
+     LCD_PrintInt( -7, 0 );           // "-7"
+     LCD_PrintFixed( 2531, 2, 6 );    // " 25.31"
+    </code>
+*/
+#define LCD_PrintUInt( x, width )   ulong2sink( (x), 10u, (width), ' ', &LCD_Sink )
+#define LCD_PrintInt( x, width )    long2sink( (x), 10u, (width), ' ', &LCD_Sink )
+#define LCD_PrintFixed( x, decimals, width )    \
+        fix2sink( (x), (decimals), (width), ' ', &LCD_Sink )
+
 
 
 /**
@@ -27,6 +27,8 @@
 #include <xc.h>
 #include "../hardware.h"
 #include "../util/utils.h"
+#include "../util/sched.h"
+#include "../util/profile.h"
 
 /******************************************************************************
  ************************** Section: Constants ********************************
@@ -163,8 +165,7 @@ static void lcd_PutNibble( uint8_t data ){
   @Comment
 	None
 */
-static void lcd_DataWrite( char data ){
-	lcd_BusyCheck();
+static void lcd_DataSend( char data ){
 	lcd_PutNibble( data>>4u );
     lcd_SendDataSignal();
 
@@ -172,6 +173,49 @@ static void lcd_DataWrite( char data ){
     lcd_SendDataSignal();
 }
 
+static void lcd_DataWrite( char data ){
+    PROFILE_BEGIN( PROFILE_ID_LCD_DATA_WRITE );
+	lcd_BusyCheck();
+	lcd_DataSend( data );
+    PROFILE_END( PROFILE_ID_LCD_DATA_WRITE );
+}
+
+/**
+  @Summary
+    Send command to LCD without check the busy flag
+*/
+static void lcd_CommandSend( LCD_CMD cmd ){
+#ifdef LCD_USE_RW
+    LCD_ControlBus &= ~( 1u<<RW );
+#endif
+    lcd_PutNibble( ((uint8_t)cmd)>>4u );
+    lcd_SendCmdSignal();
+
+    lcd_PutNibble( ((uint8_t)cmd) );
+    lcd_SendCmdSignal();
+}
+
+/**
+  @Summary
+    Wait while LCD controller is busy (inside a task).
+
+  @Description
+    if RW pin is used the busy flag is checked (a short poll).
+    if RW is not used the task waits more than 1ms (two ticks of SCHED_Tick)
+  without block the CPU.
+*/
+#ifdef LCD_USE_RW
+#define lcd_TaskBusyWait( pt )  lcd_BusyCheck()
+#else
+#define lcd_TaskBusyWait( pt )  SCHED_DELAY_MS( (pt), 1u )
+#endif
+
+static uint8_t lcd_taskIndex;   // next character or initialization step
+static uint8_t lcd_taskWait;    // delay of the initialization step
+
+#define LCD_INIT_BUSY   0u      // wait while the LCD is busy
+#define LCD_INIT_END    0xFFu   // no more initialization steps
+
 /**
   @Summary
     Get the TRISx register corresponding to a PORTx register 
@@ -237,47 +281,80 @@ void LCD_Attach( volatile uint8_t * _dataBus, uint8_t d4, uint8_t d5, uint8_t d6
 	EN = _EN;
 }
 
-/* See header file for especifications */
-void LCD_Initialize( uint8_t lines, uint8_t row ){
-	
-    BIT_ClearMask( LCD_DataBusDirection, DataMask );
-    
+/**
+  @Summary
+    One step of the LCD initialization
+
+  @Description
+    LCD_Initialize and LCD_InitializeTask run the same steps, they only
+  differ on how they wait between them.
+
+  @Returns
+    The delay in ms needed after the step, LCD_INIT_BUSY (wait while the LCD
+  is busy) or LCD_INIT_END (no more steps).
+*/
+static uint8_t lcd_InitializeStep( uint8_t step, uint8_t lines ){
+    switch( step ){
+        case 0u:
+            BIT_ClearMask( LCD_DataBusDirection, DataMask );
 #ifdef LCD_USE_RW
-    LCD_ControlBusDirection &= ~((1u<<RS) | (1u<<RW) | (1u<<EN));
+            LCD_ControlBusDirection &= ~((1u<<RS) | (1u<<RW) | (1u<<EN));
 #else
-    LCD_ControlBusDirection &= ~((1u<<RS) | (1u<<EN));
+            LCD_ControlBusDirection &= ~((1u<<RS) | (1u<<EN));
 #endif
+            return 30u;
+        case 1u:
+            // This routine is used to reset the LCD and configure on 4bits mode.
+            lcd_PutNibble( 0x03u );
+            lcd_SendCmdSignal();
+            return 100u;
+        case 2u:
+            // the 200us delays are short, they are not worth a task switch
+            lcd_PutNibble( 0x03u );
+            lcd_SendCmdSignal();
+            __delay_us(200u);
+            lcd_PutNibble( 0x03u );
+            lcd_SendCmdSignal();
+            __delay_us(200u);
+            lcd_PutNibble( 0x02u );
+            lcd_SendCmdSignal();
+            __delay_us(200u);
+            return LCD_INIT_BUSY;
+        case 3u:
+            if( lines <= 1u )
+                lcd_CommandSend( LCD_CMD_FUNCTION_SET_4BITSMODE_1LINE_5X8DOTS );
+            else
+                lcd_CommandSend( LCD_CMD_FUNCTION_SET_4BITSMODE_2LINES_5X8DOTS );
+            return LCD_INIT_BUSY;
+        case 4u:
+            lcd_CommandSend( LCD_CMD_DISPLAY_ON_CURSOR_OFF );
+            return LCD_INIT_BUSY;
+        case 5u:
+            lcd_CommandSend( LCD_CMD_CLEAR_DISPLAY );
+            return LCD_INIT_BUSY;
+        case 6u:
+            lcd_CommandSend( LCD_CMD_RETURN_HOME );
+            return 2u;
+        default:
+            return LCD_INIT_END;
+    }
+}
+
+/* See header file for especifications */
+void LCD_Initialize( uint8_t lines, uint8_t row ){
+    uint8_t step = 0u;
+    uint8_t wait;
     
-    
-    __delay_ms(30u);
-    // This routine is used to reset the LCD and configure on 4bits mode.
-    lcd_PutNibble( 0x03u );
-    lcd_SendCmdSignal();
-    __delay_ms(100u);
-    lcd_PutNibble( 0x03u );
-    lcd_SendCmdSignal();
-    __delay_us(200u);
-    lcd_PutNibble( 0x03u );
-    lcd_SendCmdSignal();
-    __delay_us(200u);
-    lcd_PutNibble( 0x02u );
-    lcd_SendCmdSignal();
-    __delay_us(200u);
-    
-    if( lines <= 1u )
-        LCD_CommandWrite( LCD_CMD_FUNCTION_SET_4BITSMODE_1LINE_5X8DOTS );
-    else
-        LCD_CommandWrite( LCD_CMD_FUNCTION_SET_4BITSMODE_2LINES_5X8DOTS );
-	
-    __delay_us(50u);
-	
-	LCD_CommandWrite( LCD_CMD_DISPLAY_ON_CURSOR_OFF );
-    __delay_us(50u);
-    
-	LCD_Clear();	
-    LCD_ReturnHome();
-    __delay_ms(2u);
-    
+    while( (wait = lcd_InitializeStep( step, lines )) != LCD_INIT_END ){
+        step++;
+        if( wait == LCD_INIT_BUSY )
+            lcd_BusyCheck();
+        else{
+            while( wait-- )
+                __delay_ms(1);
+        }
+    }
+    (void)row;
 }
 
 /* See header file for especifications */
@@ -285,18 +362,18 @@ void LCD_PrintChar( char a ){
 	lcd_DataWrite( a );	
 }
 
+static void lcd_SinkPut( void *ctx, char c ){
+    (void)ctx;
+    lcd_DataWrite( c );
+}
+
+/* See header file for especifications */
+const num2str_sink_t LCD_Sink = { lcd_SinkPut, 0 };
+
 /* See header file for especifications */
 void LCD_CommandWrite( LCD_CMD cmd ){
     lcd_BusyCheck();
-#ifdef LCD_USE_RW
-    LCD_ControlBus &= ~( 1u<<RW );
-#endif
-    lcd_PutNibble( ((uint8_t)cmd)>>4u );
-    lcd_SendCmdSignal();
-
-    lcd_PutNibble( ((uint8_t)cmd) );
-    lcd_SendCmdSignal();
-   
+    lcd_CommandSend( cmd );
 }
 
 /* See header file for especifications */
@@ -314,6 +391,37 @@ void LCD_SetCursorPosition( uint8_t line, uint8_t row ){
         LCD_CommandWrite( (0x80u | (line*0x40u)) + row );
 }
 
+/* See header file for especifications */
+uint8_t LCD_InitializeTask( pt_t *pt, uint8_t lines, uint8_t row ){
+    PT_BEGIN( pt );
+    
+    lcd_taskIndex = 0u;
+    while( (lcd_taskWait = lcd_InitializeStep( lcd_taskIndex, lines )) != LCD_INIT_END ){
+        lcd_taskIndex++;
+        if( lcd_taskWait == LCD_INIT_BUSY )
+            lcd_TaskBusyWait( pt );
+        else
+            SCHED_DELAY_MS( pt, lcd_taskWait );
+    }
+    
+    (void)row;
+    PT_END( pt );
+}
+
+/* See header file for especifications */
+uint8_t LCD_PrintStringTask( pt_t *pt, const char *str ){
+    PT_BEGIN( pt );
+    
+    lcd_taskIndex = 0u;
+    while( str[lcd_taskIndex] != '\0' ){
+        lcd_TaskBusyWait( pt );
+        lcd_DataSend( str[lcd_taskIndex] );
+        lcd_taskIndex++;
+    }
+    
+    PT_END( pt );
+}
+
 
 #endif
 /**
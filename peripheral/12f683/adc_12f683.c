@@ -17,6 +17,8 @@
 #include <xc.h>
 #include <stdint.h>
 #include "adc_12f683.h"
+#include "../../util/profile.h"
+#include "../../util/trace.h"
 
 /* Implemented as macro */
 /*
@@ -60,6 +62,8 @@ adc_result_t ADC_GetConversionResult( ){
 
 /** See header file for more information **/
 adc_result_t ADC_GetConversion( uint8_t channel ){
+    PROFILE_BEGIN( PROFILE_ID_ADC_CONVERSION );
+    
     // Select Channel
     ADCON0bits.CHS = channel;
     // Turn on the ADC Module
@@ -75,6 +79,9 @@ adc_result_t ADC_GetConversion( uint8_t channel ){
     asm( "BTFSC ADCON0,0x01" );
     asm( "GOTO $-1" );
     
+    PROFILE_END( PROFILE_ID_ADC_CONVERSION );
+    TRACE_RECORD( TRACE_ID_ADC_DONE, ADRESH );
+    
     // Conversion finished, return the result
 #if (_ADC_RESOLUTION == _ADC_RESOLUTION_10BITS)
     return ((adc_result_t)((adc_result_t)(ADRESH << 8) + ADRESL));
@@ -0,0 +1,17 @@
+/*
+ * File:   critical_12f683.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Global interrupt enable bit of the PIC12F683 for the critical sections
+ * (util/critical.h). It is the only device dependency of util/critical.h.
+ */
+
+#ifndef CRITICAL_12f683_H
+#define	CRITICAL_12f683_H
+
+#include <xc.h>
+
+#define CRITICAL_GIE    INTCONbits.GIE
+
+#endif	/* CRITICAL_12f683_H */
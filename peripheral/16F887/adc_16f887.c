@@ -25,6 +25,9 @@
 #include "../../util/utils.h"
 #include <stdint.h>
 #include "adc_16f887.h"
+#include "../../util/pt.h"
+#include "../../util/profile.h"
+#include "../../util/trace.h"
 /**
  Section: Constants
 */
@@ -50,24 +53,22 @@ void ADC_Initialize(CONVERSION_CLOCK convClock, VOLTAGE_REFERENCE voltRef){
 }
 
 void ADC_SelectChannel(adc_channel_t channel){
-    // select the A/D channel
-    ADCON0bits.CHS = channel;
-    
     //configure I/O pin as analog
     if( channel < 8 )
         ANSEL = 1u<<channel;
     else{
         ANSELH = 1u<<(channel-8);
     }
-    // Turn on the ADC module
-    ADCON0bits.ADON = 1;  
+    // select the A/D channel and turn on the ADC module (one write)
+    BIT_InsertMask( ADCON0, _ADCON0_CHS_MASK | _ADCON0_ADON_MASK,
+                    ((uint8_t)channel << _ADCON0_CHS_POSN) | _ADCON0_ADON_MASK );
 }
 
- uint16_t ADC_GetConversion(adc_channel_t channel){
-
-    // select the A/D channel
-    ADCON0bits.CHS = channel;
-    
+/**
+ * Configure the channel pin as analog input, select the channel and turn on
+ * the ADC module
+ **/
+static void adc_Setup(adc_channel_t channel){
     if( channel < 4u ){
         BIT_SetBit( TRISA, channel );
     }
@@ -86,8 +87,16 @@ void ADC_SelectChannel(adc_channel_t channel){
     else{
         ANSELH = 1u<<(channel-8);
     }
-    // Turn on the ADC module
-    ADCON0bits.ADON = 1;  
+    // select the A/D channel and turn on the ADC module (one write)
+    BIT_InsertMask( ADCON0, _ADCON0_CHS_MASK | _ADCON0_ADON_MASK,
+                    ((uint8_t)channel << _ADCON0_CHS_POSN) | _ADCON0_ADON_MASK );
+}
+
+ uint16_t ADC_GetConversion(adc_channel_t channel){
+    uint16_t result;
+    
+    PROFILE_BEGIN( PROFILE_ID_ADC_CONVERSION );
+    adc_Setup( channel );
     
     //ADC_SampleDelay();
     __delay_us(3);
@@ -99,8 +108,30 @@ void ADC_SelectChannel(adc_channel_t channel){
     while (ADCON0bits.GO_nDONE);
 
     // Conversion finished, return the result
-    return ADC_GetConversionResult();
+    result = ADC_GetConversionResult();
+    PROFILE_END( PROFILE_ID_ADC_CONVERSION );
+    TRACE_RECORD( TRACE_ID_ADC_DONE, ADRESH );
+    return result;
+}
+
+uint8_t ADC_GetConversionTask(pt_t *pt, adc_channel_t channel, adc_result_t *result){
+    PT_BEGIN( pt );
+    
+    adc_Setup( channel );
+    
+    // acquisition time, too short for a task switch
+    __delay_us(3);
+
+    // Start the conversion
+    ADCON0bits.GO_nDONE = 1;
+
+    // Wait for the conversion to finish without block
+    PT_WAIT_WHILE( pt, ADCON0bits.GO_nDONE );
+
+    *result = ADC_GetConversionResult();
+    TRACE_RECORD( TRACE_ID_ADC_DONE, ADRESH );
     
+    PT_END( pt );
 }
 
 #endif
@@ -25,6 +25,7 @@
 #include <xc.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "../../util/pt.h"
 
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -276,6 +277,36 @@ adc_result_t ADC_GetConversionResult();
     </code>
 */
  uint16_t ADC_GetConversion(adc_channel_t channel);
+
+/**
+  @Summary
+    Non blocking version of ADC_GetConversion
+
+  @Description
+    Protothread task (see util/pt.h): select the channel, start the 
+  conversion and return while GO/DONE is set instead of spinning on it.
+    Call it (with the same arguments) until it returns PT_ENDED.
+
+  @Preconditions
+    ADC_Initialize() function should have been called before calling this function.
+
+  @Returns
+    PT_WAITING while the conversion is running, PT_ENDED when *result has 
+  the converted value.
+
+  @Param
+    - pt: Task control block, initialized with PT_INIT.
+    - channel: channel to convert.
+    - result: where the converted value is stored.
+
+  @Example
+    <code>
+    static adc_result_t temp;
+
+    PT_SPAWN( pt, &ptAdc, ADC_GetConversionTask( &ptAdc, AN1_Channel, &temp ) );
+    </code>
+*/
+uint8_t ADC_GetConversionTask(pt_t *pt, adc_channel_t channel, adc_result_t *result);
  
 /**
   @Summary
@@ -0,0 +1,17 @@
+/*
+ * File:   critical_16f887.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Global interrupt enable bit of the PIC16F887 for the critical sections
+ * (util/critical.h). It is the only device dependency of util/critical.h.
+ */
+
+#ifndef CRITICAL_16f887_H
+#define	CRITICAL_16f887_H
+
+#include <xc.h>
+
+#define CRITICAL_GIE    INTCONbits.GIE
+
+#endif	/* CRITICAL_16f887_H */
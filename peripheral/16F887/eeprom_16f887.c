@@ -23,6 +23,9 @@
 #include <xc.h>
 #include <stdint.h>
 #include "../eeprom.h"
+#include "../../util/pt.h"
+#include "../../util/critical.h"
+#include "../../util/profile.h"
 /**
  Section: Constants
 */
@@ -52,10 +55,10 @@ uint8_t EEPROM_ReadByte(uint8_t address){
     return EEDATA;
 }
 
-void EEPROM_WriteByte(uint8_t address, uint8_t data){
-    // wait until end read or write pending operations
-    while( EECON1 & 0x03 );
-    
+/**
+ * Load the address and data and start the write sequence (no wait)
+ **/
+static void eeprom_StartWrite(uint8_t address, uint8_t data){
     // Data Memory Address to write
     EEADR = address;
     
@@ -68,23 +71,48 @@ void EEPROM_WriteByte(uint8_t address, uint8_t data){
     // Enable Write
     EECON1bits.WREN = 1;
     
-    //Disable INTs
-    INTCONbits.GIE = 0;
-    //Sequence
+    // the unlock sequence can not be interrupted (GIE is restored, not set)
+    CRITICAL_ENTER();
     EECON2 = 0x55;
     EECON2 = 0xAA;
     
     //Start to write
     EECON1bits.WR = 1;
+    CRITICAL_EXIT();
+}
+
+void EEPROM_WriteByte(uint8_t address, uint8_t data){
+    PROFILE_BEGIN( PROFILE_ID_EEPROM_WRITE );
+    
+    // wait until end read or write pending operations
+    while( EECON1 & 0x03 );
     
-    //Disable INTs
-    INTCONbits.GIE = 1;
+    eeprom_StartWrite( address, data );
     
     // Wait until end write operation
     while( EECON1 & 0x03 );
     
     // Disable Write
     EECON1bits.WREN = 0;
+    
+    PROFILE_END( PROFILE_ID_EEPROM_WRITE );
+}
+
+uint8_t EEPROM_WriteByteTask(pt_t *pt, uint8_t address, uint8_t data){
+    PT_BEGIN( pt );
+    
+    // wait until end read or write pending operations
+    PT_WAIT_WHILE( pt, EECON1 & 0x03 );
+    
+    eeprom_StartWrite( address, data );
+    
+    // Wait until end write operation (about 5ms) without block
+    PT_WAIT_WHILE( pt, EECON1 & 0x03 );
+    
+    // Disable Write
+    EECON1bits.WREN = 0;
+    
+    PT_END( pt );
 }
 
 void EEPROM_WriteNBytes(uint8_t address, uint8_t *data, uint8_t len ){
@@ -102,6 +130,13 @@ void EEPROM_ReadNBytes(uint8_t address, uint8_t *data, uint8_t len ){
     }
 }
 
+void EEPROM_SinkPut( void *ctx, char c ){
+    uint8_t *address = (uint8_t*)ctx;
+    
+    EEPROM_WriteByte( *address, (uint8_t)c );
+    (*address)++;
+}
+
 
 #endif
 /**
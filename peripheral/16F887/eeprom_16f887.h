@@ -25,6 +25,7 @@
 #include <xc.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "../../util/pt.h"
 
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -73,6 +74,40 @@
 */
 void EEPROM_WriteByte(uint8_t address, uint8_t data);
 
+/**
+  @Summary
+    Non blocking version of EEPROM_WriteByte
+
+  @Description
+    Protothread task (see util/pt.h): start the write and return while the
+  EEPROM is busy (the write takes about 5ms) instead of spinning on WR.
+    Call it (with the same arguments) until it returns PT_ENDED.
+
+  @Preconditions
+    None
+
+  @Param
+    - pt: Task control block, initialized with PT_INIT.
+    
+    - address: Address to store the data.
+          
+    - data: Data to be stored.
+    
+  @Returns
+    PT_WAITING while the write is running, PT_ENDED when it finished.
+
+  @Comment
+    Do not call the other EEPROM routines while the task is running.
+
+  @Example
+    <code>
+
+    PT_SPAWN( pt, &ptEeprom, EEPROM_WriteByteTask( &ptEeprom, 0x05, 12 ) );
+
+    </code>
+*/
+uint8_t EEPROM_WriteByteTask(pt_t *pt, uint8_t address, uint8_t data);
+
 
 /**
   @Summary
@@ -153,6 +188,25 @@ void EEPROM_WriteNBytes(uint8_t address, uint8_t *data, uint8_t len );
 */
 void EEPROM_ReadNBytes(uint8_t address, uint8_t *data, uint8_t len );
 
+/**
+  @Summary
+    Character sink routine that write to the EEPROM
+
+  @Description
+    Put routine for a num2str_sink_t (see util/num2str.h): write c on the
+  address pointed by ctx (uint8_t*) and increment it. Each character waits
+  the end of the previous write (about 5ms).
+
+  @Example
+    <code>
+    uint8_t address = 0x00;
+    const num2str_sink_t eepromSink = { EEPROM_SinkPut, &address };
+    
+    TRACE_Dump( &eepromSink, TRACE_DUMP_BINARY );
+    </code>
+*/
+void EEPROM_SinkPut( void *ctx, char c );
+
 
 #ifdef __cplusplus  // Provide C++ Compatibility
 
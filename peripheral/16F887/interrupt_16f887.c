@@ -0,0 +1,70 @@
+/**
+  Interrupt Dispatcher File
+
+  @Author
+    Jose Guerra Carmenate.
+
+  @File Name
+    interrupt_16f887.c
+
+  @Summary
+    This is the implementation file for the interrupt dispatcher statistics
+  using PIC16F887 MCU.
+
+  @Description
+    The dispatcher itself is the ISR_DISPATCH macro (see interrupt_16f887.h).
+    Compiler          :  XC8 2.00
+    MPLAB             :  MPLAB X 5.10
+*/
+
+#ifdef _16F887
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include <stdint.h>
+#include "interrupt_16f887.h"
+#include "../../util/critical.h"
+
+#if ISR_STATS
+/**
+ Section: Global Vars
+*/
+
+isr_stats_t isr_stats[ISR_SRC_COUNT];
+uint16_t isr_spurious;
+
+/**
+  Section: Interrupt Dispatcher APIs
+*/
+
+void ISR_StatsUpdate( uint8_t source, uint16_t dispatch, uint16_t duration ){
+    isr_stats_t *s = &isr_stats[source];
+    
+    if( s->count != 0xFFFFu )
+        s->count++;
+    if( dispatch > s->maxDispatch )
+        s->maxDispatch = dispatch;
+    if( duration > s->maxDuration )
+        s->maxDuration = duration;
+}
+
+void ISR_StatsClear( void ){
+    uint8_t i;
+    
+    CRITICAL_ENTER();
+    for( i = 0; i < ISR_SRC_COUNT; i++ ){
+        isr_stats[i].count = 0u;
+        isr_stats[i].maxDispatch = 0u;
+        isr_stats[i].maxDuration = 0u;
+    }
+    isr_spurious = 0u;
+    CRITICAL_EXIT();
+}
+
+#endif
+#endif
+/**
+ End of File
+*/
@@ -0,0 +1,213 @@
+/**
+  Interrupt Dispatcher API Header File for PIC16F887
+
+  @Author
+    Jose Guerra Carmenate
+
+  @File Name
+    interrupt_16f887.h
+
+  @Summary
+    This is the header file for the interrupt dispatcher using PIC16F887 MCUs
+
+  @Description
+    The PIC16 has only one interrupt vector. ISR_DISPATCH() expands on the
+  interrupt routine to a chain of flag checks, one for every source with a
+  bound handler, in the order of ISR_PRIORITY. The handlers are bound at
+  compile time on interrupt_16f887_config.h (ISR_<src>_HANDLER), so they
+  are direct calls: no function pointers on the ISR.
+    A source is served when its enable bit and its flag are set; the handler
+  must clear the flag.
+    With ISR_STATS = 1 (default on debug builds) every served source count
+  the calls and the worst dispatch delay and duration in Timer1 counts (see
+  isr_stats_t). With TRACE_ENABLE = 1 every served source is recorded as a
+  TRACE_ID_ISR event (see util/trace.h).
+
+  @Example
+    <code>
+    void __interrupt() isr( void ){
+        ISR_DISPATCH();
+    }
+    </code>
+*/
+
+
+#ifndef INTERRUPT_16f887_H
+#define INTERRUPT_16f887_H
+
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include <stdint.h>
+#include "interrupt_16f887_config.h"
+#include "../../util/profile.h"
+#include "../../util/trace.h"
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+
+        
+/**
+  Section: Data Types Definitions
+*/
+
+/**
+ * Sources (index of isr_stats)
+ **/
+enum{
+    ISR_SRC_TMR0 = 0,
+    ISR_SRC_TMR1,
+    ISR_SRC_SSP,
+    ISR_SRC_AD,
+    ISR_SRC_EE,
+    ISR_SRC_RC,
+    ISR_SRC_COUNT
+};
+
+#if ISR_STATS
+/**
+ * Statistics of a source, in Timer1 counts:
+ *  - maxDispatch: from the entry of ISR_DISPATCH to the handler call (the
+ *    sources checked before it). It is not the interrupt latency: the
+ *    hardware latency and the context save done by the compiler before
+ *    ISR_DISPATCH are not included.
+ *  - maxDuration: the handler call.
+ **/
+typedef struct{
+    uint16_t count;         // served interrupts (saturate at 65535)
+    uint16_t maxDispatch;   // Timer1 counts
+    uint16_t maxDuration;   // Timer1 counts
+} isr_stats_t;
+
+extern isr_stats_t isr_stats[ISR_SRC_COUNT];
+extern uint16_t isr_spurious;   // interrupts without any source served
+#endif
+
+/**
+  Section: Dispatcher internals (used by ISR_DISPATCH)
+*/
+
+#define isr_PENDING_TMR0    ( INTCONbits.T0IE && INTCONbits.T0IF )
+#define isr_PENDING_TMR1    ( PIE1bits.TMR1IE && PIR1bits.TMR1IF )
+#define isr_PENDING_SSP     ( PIE1bits.SSPIE && PIR1bits.SSPIF )
+#define isr_PENDING_AD      ( PIE1bits.ADIE && PIR1bits.ADIF )
+#define isr_PENDING_EE      ( PIE2bits.EEIE && PIR2bits.EEIF )
+#define isr_PENDING_RC      ( PIE1bits.RCIE && PIR1bits.RCIF )
+
+#if ISR_STATS
+#define isr_SERVE( src, handler )   if( isr_PENDING_##src ){                \
+            uint16_t isr_start = PROFILE_Now();                             \
+            TRACE_RECORD( TRACE_ID_ISR, ISR_SRC_##src );                    \
+            handler;                                                        \
+            ISR_StatsUpdate( ISR_SRC_##src, isr_start - isr_entry,          \
+                             PROFILE_Now() - isr_start );                   \
+            isr_served = 1u;                                                \
+        }
+#define isr_BEGIN()     uint16_t isr_entry = PROFILE_Now();                 \
+                        uint8_t isr_served = 0u;
+#define isr_END()       if( !isr_served ) isr_spurious++;
+#else
+#define isr_SERVE( src, handler )   if( isr_PENDING_##src ){                \
+            TRACE_RECORD( TRACE_ID_ISR, ISR_SRC_##src );                    \
+            handler;                                                        \
+        }
+#define isr_BEGIN()
+#define isr_END()
+#endif
+
+#ifdef ISR_TMR0_HANDLER
+#define isr_Serve_TMR0()    isr_SERVE( TMR0, ISR_TMR0_HANDLER() )
+#else
+#define isr_Serve_TMR0()
+#endif
+#ifdef ISR_TMR1_HANDLER
+#define isr_Serve_TMR1()    isr_SERVE( TMR1, ISR_TMR1_HANDLER() )
+#else
+#define isr_Serve_TMR1()
+#endif
+#ifdef ISR_SSP_HANDLER
+#define isr_Serve_SSP()     isr_SERVE( SSP, ISR_SSP_HANDLER() )
+#else
+#define isr_Serve_SSP()
+#endif
+#ifdef ISR_AD_HANDLER
+#define isr_Serve_AD()      isr_SERVE( AD, ISR_AD_HANDLER() )
+#else
+#define isr_Serve_AD()
+#endif
+#ifdef ISR_EE_HANDLER
+#define isr_Serve_EE()      isr_SERVE( EE, ISR_EE_HANDLER() )
+#else
+#define isr_Serve_EE()
+#endif
+#ifdef ISR_RC_HANDLER
+#define isr_Serve_RC()      isr_SERVE( RC, ISR_RC_HANDLER() )
+#else
+#define isr_Serve_RC()
+#endif
+
+#define isr_SOURCE( src )   isr_Serve_##src()
+
+
+/**
+  Section: Interrupt Dispatcher APIs
+*/
+
+/**
+  @Summary
+    Serve the pending interrupt sources
+
+  @Description
+    Check the bound sources in the ISR_PRIORITY order and call the handler
+  of every pending one.
+
+  @Preconditions
+    Must be used once, inside the interrupt routine.
+
+  @Example
+    <code>
+    void __interrupt() isr( void ){
+        ISR_DISPATCH();
+    }
+    </code>
+*/
+#define ISR_DISPATCH()  do{                                                 \
+            isr_BEGIN()                                                     \
+            ISR_PRIORITY( isr_SOURCE )                                      \
+            isr_END()                                                       \
+        }while(0)
+
+#if ISR_STATS
+/**
+  @Summary
+    Add one served interrupt to the statistics of 'source' (used by
+  ISR_DISPATCH)
+*/
+void ISR_StatsUpdate( uint8_t source, uint16_t dispatch, uint16_t duration );
+
+/**
+  @Summary
+    Clear the statistics
+
+  @Description
+    The interrupts are disabled while the counters are cleared, GIE is
+  restored.
+*/
+void ISR_StatsClear( void );
+#endif
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+
+#endif	//INTERRUPT_16f887_H
+/**
+ End of File
+*/
@@ -0,0 +1,64 @@
+/**
+  Interrupt Dispatcher configuration header File for PIC16F887
+
+  @Author
+    Jose Guerra Carmenate
+
+  @File Name
+    interrupt_16f887_config.h
+
+  @Summary
+    Handlers, check order and statistics of the interrupt dispatcher (see
+  interrupt_16f887.h).
+
+  @Description
+    Every option is wrapped in #ifndef, so it can also be set from the
+  compiler command line (Ej: -DISR_STATS=0) without edit this file.
+    A source is compiled only when its ISR_<src>_HANDLER macro is defined:
+  uncomment the line of the sources used (and include the header of the
+  handler below), or comment the TMR0 line when Timer0 is not used.
+*/
+
+#ifndef INTERRUPT_16f887_CONFIG_H
+#define INTERRUPT_16f887_CONFIG_H
+
+#include "tmr0_16f887.h"
+
+/**
+ * Handlers (the routine called when the source is pending)
+ **/
+#ifndef ISR_TMR0_HANDLER
+#define ISR_TMR0_HANDLER()      TMR0_InterruptHandler()
+#endif
+//#define ISR_TMR1_HANDLER()    TMR1_InterruptHandler()
+//#define ISR_SSP_HANDLER()     SPI_InterruptHandler()  // or SPI_SlaveInterruptHandler()
+//#define ISR_AD_HANDLER()      ADC_InterruptHandler()
+//#define ISR_EE_HANDLER()      EEPROM_InterruptHandler()
+//#define ISR_RC_HANDLER()      UART_RxInterruptHandler()
+
+/**
+ * Check order, first the higher priority. All the pending sources are
+ * served on the same interrupt.
+ **/
+#ifndef ISR_PRIORITY
+#define ISR_PRIORITY( S )   S( TMR0 ) S( SSP ) S( RC ) S( AD ) S( TMR1 ) S( EE )
+#endif
+
+/**
+ * Statistics (count, dispatch delay and duration per source). Enabled on
+ * debug builds by default.
+ *  The time is read from Timer1 (PROFILE_Now), it must be running (Ej:
+ * started by PROFILE_Initialize, or T1CON = 0x01).
+ **/
+#ifndef ISR_STATS
+#ifdef __DEBUG
+#define ISR_STATS   1
+#else
+#define ISR_STATS   0
+#endif
+#endif
+
+#endif	//INTERRUPT_16f887_CONFIG_H
+/**
+ End of File
+*/
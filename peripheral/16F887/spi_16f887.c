@@ -1,14 +1,14 @@
 /**
-  ADC Driver File
+  SPI Driver File
 
   @Author
     Jose Guerra Carmenate.
 
   @File Name
-    adc_16f887.c
+    spi_16f887.c
 
   @Summary
-    This is the driver implementation file for the ADC driver using PIC16F887 MCU.
+    This is the driver implementation file for the SPI (MSSP) driver using PIC16F887 MCU.
 
   @Description
     Compiler          :  XC8 1.45
@@ -21,8 +21,13 @@
 */
 
 #include <xc.h>
+#include <stddef.h>
 #include "../spi.h"
 #include "../../util/utils.h"
+#include "../../util/trace.h"
+#include "../../util/ringbuffer.h"
+#include "../../util/profile.h"
+#include "../../util/critical.h"
 
 
 /**
@@ -40,6 +45,10 @@
 #define _SPI_SS_TRIS TRISAbits.TRISA5
 #define _SPI_SS_PORT PORTAbits.RA5
 
+// SSPM values of the slave mode
+#define _SPI_SSPM_SLAVE_SS      0b0100u     // SS pin enabled
+#define _SPI_SSPM_SLAVE         0b0101u     // SS pin disabled
+
 #ifndef INPUT
 #define INPUT 1
 #endif
@@ -49,10 +58,134 @@
 #endif
 
 /**
- Section: Constants
+ Section: Local Vars
+*/
+
+// queued transactions: producer main (SPI_QueueXxx), consumer the ISR
+RINGBUFFER_DEFINE( spi_queue, spi_transaction_t, SPI_QUEUE_SIZE )
+
+static spi_transaction_t spi_current;   // transaction in progress (ISR)
+static volatile uint8_t spi_active;     // spi_current in progress
+static uint8_t spi_pending;             // blocking byte sent, not read
+static uint8_t spi_sspie;               // SSPIE saved by spi_Lock
+static uint8_t spi_sspcon;              // configuration on the MSSP
+static uint8_t spi_sspstat;
+
+// slave mode: responses (main -> ISR) and received bytes (ISR -> main)
+RINGBUFFER_DEFINE( spi_slaveTx, uint8_t, SPI_SLAVE_TX_SIZE )
+RINGBUFFER_DEFINE( spi_slaveRx, uint8_t, SPI_SLAVE_RX_SIZE )
+
+static volatile spi_slave_stats_t spi_slaveStats;
+
+/**
+ Section: Local Routines
 */
 
+/**
+ * Blocking routines: mask the SSP interrupt while they own the MSSP, so the
+ * queue ISR does not read SSPBUF (and clear BF) of a blocking byte. The
+ * queue must be idle.
+ **/
+static void spi_Lock( void ){
+    spi_sspie = PIE1bits.SSPIE;
+    PIE1bits.SSPIE = 0;
+}
+
+/**
+ * Restore the SSP interrupt. The caller clears the SSPIF of its own bytes
+ * after the last BF poll (spi_WaitLastBF), any other SSPIF (a queue start)
+ * is kept.
+ **/
+static void spi_Unlock( void ){
+    if( spi_sspie )
+        PIE1bits.SSPIE = 1;
+}
+
+/**
+ * Wait the end of the last blocking byte and clear its SSPIF (and the one
+ * of the previous bytes of the block)
+ **/
+#define spi_WaitLastBF()    do{ while( !(SSPSTAT & _SSPSTAT_BF_MASK) );          \
+                                PIR1bits.SSPIF = 0; }while(0)
+
+/**
+ * Wait the end of the queue and of the last byte sent by SPI_WriteByte.
+ * The queue advances on the ISR: with GIE clear and a queued transaction in
+ * progress it waits forever (see SPI_QueueInitialize).
+ **/
+static void spi_WaitIdle( void ){
+    while( spi_active );
+    if( spi_pending ){
+        spi_WaitLastBF();
+        spi_pending = 0u;
+        spi_Unlock();
+    }
+}
+
+/**
+ * Wait the end of the byte in progress (block routines)
+ **/
+#define spi_WaitBF()    while( !(SSPSTAT & _SSPSTAT_BF_MASK) )
+
+/**
+ * Block routines start: wait idle, clear a previous collision and start
+ * the measure
+ **/
+static void spi_BlockBegin( void ){
+    spi_WaitIdle();
+    spi_Lock();
+    BIT_ClearMask( SSPCON, _SSPCON_WCOL_MASK );
+    PROFILE_BEGIN( PROFILE_ID_SPI_BLOCK );
+}
+
+/**
+ * Block routines end: return false if a write collision happened
+ **/
+static bool spi_BlockEnd( void ){
+    PROFILE_END( PROFILE_ID_SPI_BLOCK );
+    spi_Unlock();
+    if( SSPCON & _SSPCON_WCOL_MASK ){
+        BIT_ClearMask( SSPCON, _SSPCON_WCOL_MASK );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Drive the chip select of a device
+ **/
+#define spi_CsLow( dev )    do{ if( (dev)->cs.port != NULL )                    \
+                                BIT_ClearMask( *(dev)->cs.port, (dev)->cs.mask ); }while(0)
+#define spi_CsHigh( dev )   do{ if( (dev)->cs.port != NULL )                    \
+                                BIT_SetMask( *(dev)->cs.port, (dev)->cs.mask ); }while(0)
+
+/**
+ * Configure the MSSP for dev, only if the configuration changes. The bus
+ * must be idle. Called from main (SPI_Begin) and from the ISR (queue), the
+ * compiler duplicates it.
+ **/
+static void spi_Configure( const spi_device_t *dev ){
+    if( dev->sspcon == spi_sspcon && dev->sspstat == spi_sspstat )
+        return;
+    
+    SSPCON = 0;                 // power off: CKP and CKE change on reset
+    BIT_InsertMask( SSPSTAT, _SSPSTAT_CKE_MASK | _SSPSTAT_SMP_MASK, dev->sspstat );
+    SSPCON = dev->sspcon | _SSPCON_SSPEN_MASK;
+    spi_sspcon = dev->sspcon;
+    spi_sspstat = dev->sspstat;
+}
 
+/**
+ * Send the next byte of the current transaction
+ **/
+static void spi_SendNext( void ){
+    uint8_t byte = 0xFFu;
+    
+    if( spi_current.tx != NULL )
+        byte = *spi_current.tx++;
+    SSPBUF = byte;
+    TRACE_RECORD( TRACE_ID_SPI_BYTE, byte );
+}
 
 /**
   Section: SPI Module APIs
@@ -60,40 +193,311 @@
 
 /* See header file for especifications */
 void SPI_InitializeMaster( SPI_CLOCK_RATE bitRate, SPI_CLOCK_POLARITY clkPolarity, SPI_OUTPUT_DATA_PHASE clkEdge, SPI_INPUT_SAMPLING_PHASE inSample){
+    spi_WaitIdle();             // a re-init: the queue restores SSPIE first
     SSPCON = 0;                 // Power off the SSP module
     
     _SPI_SDO_TRIS = OUTPUT;      // configure SDO pin as output
     _SPI_SCK_TRIS = OUTPUT;      // configure SCK pin as output
     _SPI_SDI_TRIS = INPUT;
     
-    SSPCON |= bitRate;          // set the SSP module as SPI and the selected bit rate.
-	SSPCON |= clkPolarity;      // set the CKP bit value
+    // set the SSP module as SPI, the selected bit rate and the CKP bit value
+    SSPCON = (uint8_t)bitRate | (uint8_t)clkPolarity;
  
-    SSPSTAT |= clkEdge;         // set the CKE bit value
-    SSPSTAT |= inSample;        // set the SMP bit value
+    // set the CKE and SMP bit values (one write)
+    BIT_InsertMask( SSPSTAT, _SSPSTAT_CKE_MASK | _SSPSTAT_SMP_MASK,
+                    (uint8_t)clkEdge | (uint8_t)inSample );
     
-    SSPCON |= _SSPCON_SSPEN_MASK; // Power on the SSP module
+    BIT_SetBit8( SSPCON, _SSPCON_SSPEN_POSN ); // Power on the SSP module
+    spi_Lock();
     SSPBUF = 0;
-   // SSPSTATbits.BF = 1;
+    spi_pending = 1u;
+    
+    spi_sspcon = (uint8_t)bitRate | (uint8_t)clkPolarity;
+    spi_sspstat = (uint8_t)clkEdge | (uint8_t)inSample;
+}
+
+/* See header file for especifications */
+void SPI_Begin( const spi_device_t *dev ){
+    spi_WaitIdle();
+    spi_Configure( dev );
+    spi_CsLow( dev );
+}
+
+/* See header file for especifications */
+void SPI_End( const spi_device_t *dev ){
+    spi_WaitIdle();
+    spi_CsHigh( dev );
 }
 
 /* See header file for especifications */
 inline void SPI_WriteByte( uint8_t byte ){
-    while( !(SSPSTAT & _SSPSTAT_BF_MASK) );
+    spi_WaitIdle();
+    spi_Lock();
     SSPBUF;                                  
     SSPBUF = (byte);                         
+    spi_pending = 1u;
+    TRACE_RECORD( TRACE_ID_SPI_BYTE, byte );
 }
 
 
 /* See header file for especifications */
 inline bool SPI_IsBusy() {
-    return ((SSPSTAT & _SSPSTAT_BF_MASK)?0u:1u);
+    if( spi_active )
+        return true;
+    return (spi_pending && !(SSPSTAT & _SSPSTAT_BF_MASK));
 } 
 
 /* See header file for especifications */
 uint8_t SPI_ReadByte( ){
+    uint8_t data;
+    
+    while( spi_active );
+    // wait BF even without a pending byte, as the blocking driver always did
     while( !(SSPSTAT & _SSPSTAT_BF_MASK) );
-    return SSPBUF;
+    data = SSPBUF;
+    if( spi_pending ){
+        PIR1bits.SSPIF = 0;             // the flag of our byte
+        spi_pending = 0u;
+        spi_Unlock();
+    }
+    return data;
+}
+
+/* See header file for especifications */
+bool SPI_Transfer( const uint8_t *tx, uint8_t *rx, uint8_t len ){
+    uint8_t next, data;
+    
+    if( len == 0u )
+        return true;
+    spi_BlockBegin();
+    
+    SSPBUF = (tx != NULL) ? *tx++ : 0xFFu;
+    while( --len ){
+        // prepare the next byte while the current one is shifted
+        next = (tx != NULL) ? *tx++ : 0xFFu;
+        spi_WaitBF();
+        data = SSPBUF;                  // read first (it clears BF)
+        SSPBUF = next;                  // and start the next byte at once
+        if( rx != NULL )
+            *rx++ = data;
+    }
+    spi_WaitLastBF();
+    data = SSPBUF;
+    if( rx != NULL )
+        *rx = data;
+    
+    return spi_BlockEnd();
+}
+
+/* See header file for especifications */
+bool SPI_WriteBlock( const uint8_t *tx, uint8_t len ){
+    uint8_t next;
+    
+    if( len == 0u )
+        return true;
+    spi_BlockBegin();
+    
+    SSPBUF = *tx++;
+    while( --len ){
+        next = *tx++;
+        spi_WaitBF();
+        SSPBUF;                         // clear BF
+        SSPBUF = next;
+    }
+    spi_WaitLastBF();
+    SSPBUF;
+    
+    return spi_BlockEnd();
+}
+
+/* See header file for especifications */
+bool SPI_ReadBlock( uint8_t *rx, uint8_t len, uint8_t fill ){
+    uint8_t data;
+    
+    if( len == 0u )
+        return true;
+    spi_BlockBegin();
+    
+    SSPBUF = fill;
+    while( --len ){
+        spi_WaitBF();
+        data = SSPBUF;                  // read and start the next byte at
+        SSPBUF = fill;                  // once, store it while it shifts
+        *rx++ = data;
+    }
+    spi_WaitLastBF();
+    *rx = SSPBUF;
+    
+    return spi_BlockEnd();
+}
+
+/* See header file for especifications */
+void SPI_InitializeSlave( SPI_CLOCK_POLARITY clkPolarity, SPI_OUTPUT_DATA_PHASE clkEdge, bool useSS ){
+    uint8_t tx;
+    
+    spi_WaitIdle();             // end of the master transfers
+    SSPCON = 0;                 // Power off the SSP module
+    
+    _SPI_SDO_TRIS = OUTPUT;
+    _SPI_SCK_TRIS = INPUT;      // clock from the master
+    _SPI_SDI_TRIS = INPUT;
+    if( useSS ){
+        ANSELbits.ANS4 = 0;     // RA5/AN4 digital
+        _SPI_SS_TRIS = INPUT;
+    }
+    
+    // SMP must be clear on slave mode
+    BIT_InsertMask( SSPSTAT, _SSPSTAT_CKE_MASK | _SSPSTAT_SMP_MASK, (uint8_t)clkEdge );
+    SSPCON = (useSS ? _SPI_SSPM_SLAVE_SS : _SPI_SSPM_SLAVE) | (uint8_t)clkPolarity;
+    BIT_SetBit8( SSPCON, _SSPCON_SSPEN_POSN ); // Power on the SSP module
+    // first response: the first queued byte (SPI_SlaveWrite before the
+    // initialization) or the fill byte
+    if( !spi_slaveTx_Pop( &tx ) )
+        tx = SPI_SLAVE_FILL;
+    SSPBUF = tx;
+    
+    spi_sspcon = 0xFFu;         // invalid: the next SPI_Begin configures
+    SPI_SlaveStatsClear();
+    
+    PIR1bits.SSPIF = 0;
+    PIE1bits.SSPIE = 1;
+    INTCONbits.PEIE = 1;
+}
+
+/* See header file for especifications */
+bool SPI_SlaveWrite( uint8_t byte ){
+    return spi_slaveTx_Push( byte );
+}
+
+/* See header file for especifications */
+uint8_t SPI_SlaveWriteBlock( const uint8_t *buf, uint8_t len ){
+    return spi_slaveTx_PushBlock( buf, len );
+}
+
+/* See header file for especifications */
+bool SPI_SlaveRead( uint8_t *byte ){
+    return spi_slaveRx_Pop( byte );
+}
+
+/* See header file for especifications */
+uint8_t SPI_SlaveAvailable( void ){
+    return spi_slaveRx_Count();
+}
+
+/* See header file for especifications */
+void SPI_SlaveGetStats( spi_slave_stats_t *stats ){
+    CRITICAL_ENTER();
+    *stats = spi_slaveStats;
+    CRITICAL_EXIT();
+}
+
+/* See header file for especifications */
+void SPI_SlaveStatsClear( void ){
+    CRITICAL_ENTER();
+    spi_slaveStats.overflow = 0u;
+    spi_slaveStats.collision = 0u;
+    spi_slaveStats.rxDropped = 0u;
+    CRITICAL_EXIT();
+}
+
+/* See header file for especifications */
+void SPI_SlaveInterruptHandler( void ){
+    uint8_t rx, tx;
+    
+    PIR1bits.SSPIF = 0;
+    
+    // the next response first: the master can start the next byte now
+    rx = SSPBUF;                            // clears BF
+    if( !spi_slaveTx_Pop( &tx ) )
+        tx = SPI_SLAVE_FILL;
+    SSPBUF = tx;
+    
+    if( SSPCON & _SSPCON_WCOL_MASK ){
+        BIT_ClearMask( SSPCON, _SSPCON_WCOL_MASK );
+        spi_slaveStats.collision++;
+    }
+    if( SSPCON & _SSPCON_SSPOV_MASK ){
+        BIT_ClearMask( SSPCON, _SSPCON_SSPOV_MASK );
+        spi_slaveStats.overflow++;
+    }
+    
+    if( !spi_slaveRx_Push( rx ) )
+        spi_slaveStats.rxDropped++;
+    TRACE_RECORD( TRACE_ID_SPI_BYTE, rx );
+}
+
+/* See header file for especifications */
+void SPI_QueueInitialize( void ){
+    spi_WaitIdle();
+    PIR1bits.SSPIF = 0;
+    PIE1bits.SSPIE = 1;
+    INTCONbits.PEIE = 1;
+}
+
+/* See header file for especifications */
+bool SPI_QueueTransfer( const spi_device_t *dev, const uint8_t *tx, uint8_t *rx, uint8_t len, spi_callback_t done ){
+    spi_transaction_t t;
+    
+    if( len == 0u )
+        return false;
+    t.dev = dev;
+    t.tx = tx;
+    t.rx = rx;
+    t.len = len;
+    t.done = done;
+    if( !spi_queue_Push( t ) )
+        return false;
+    
+    // idle: a byte of SPI_WriteByte can be on the way, wait it and start
+    // the ISR setting the flag (the ISR takes the transaction)
+    if( !spi_active ){
+        spi_WaitIdle();             // restores SSPIE
+        PIR1bits.SSPIF = 1;
+    }
+    return true;
+}
+
+/* See header file for especifications */
+bool SPI_QueueWrite( const spi_device_t *dev, const uint8_t *buf, uint8_t len, spi_callback_t done ){
+    return SPI_QueueTransfer( dev, buf, NULL, len, done );
+}
+
+/* See header file for especifications */
+bool SPI_QueueIsBusy( void ){
+    return spi_active || spi_queue_Count();
+}
+
+/* See header file for especifications */
+void SPI_InterruptHandler( void ){
+    PIR1bits.SSPIF = 0;
+    
+    if( spi_active ){
+        // one byte of the current transaction finished
+        uint8_t data = SSPBUF;
+        
+        if( spi_current.rx != NULL )
+            *spi_current.rx++ = data;
+        if( --spi_current.len ){
+            spi_SendNext();
+            return;
+        }
+        if( spi_current.dev != NULL )
+            spi_CsHigh( spi_current.dev );
+        if( spi_current.done != NULL )
+            spi_current.done();
+    }
+    
+    // start the next transaction (SSPIF set by SPI_QueueTransfer when idle)
+    if( spi_queue_Pop( &spi_current ) ){
+        spi_active = 1u;
+        if( spi_current.dev != NULL ){
+            spi_Configure( spi_current.dev );
+            spi_CsLow( spi_current.dev );
+        }
+        spi_SendNext();
+    }
+    else
+        spi_active = 0u;
 }
 
 #endif
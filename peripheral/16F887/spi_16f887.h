@@ -69,6 +69,83 @@ typedef enum{
     SPI_INPUT_SAMPLING_PHASE_AT_END     = _SSPSTAT_SMP_MASK,
 } SPI_INPUT_SAMPLING_PHASE;
 
+/**
+ * Transactions on the interrupt driven queue (SPI_QueueXxx routines), power
+ * of two up to 128
+ **/
+#ifndef SPI_QUEUE_SIZE
+#define SPI_QUEUE_SIZE  4u
+#endif
+#if (SPI_QUEUE_SIZE) < 2u || (SPI_QUEUE_SIZE) > 128u || ((SPI_QUEUE_SIZE) & ((SPI_QUEUE_SIZE) - 1u)) != 0u
+#error "SPI_QUEUE_SIZE must be a power of two (2 to 128)"
+#endif
+
+/**
+ * Chip select of a transaction (active low): bit 'mask' of 'port'
+ **/
+typedef struct{
+    volatile uint8_t *port;
+    uint8_t mask;
+} spi_cs_t;
+
+/**
+ * Device on the bus: chip select and bus configuration (clock rate, clock
+ * polarity and phases) as the SSPCON and SSPSTAT values, computed once by
+ * SPI_DEVICE. See SPI_Begin.
+ **/
+typedef struct{
+    spi_cs_t cs;                // cs.port NULL: chip select driven by the caller
+    uint8_t sspcon;             // SSPM and CKP bits
+    uint8_t sspstat;            // CKE and SMP bits
+} spi_device_t;
+
+/**
+ * spi_device_t initializer (constants only, so the device can be const)
+ * Ej: static const spi_device_t dac = SPI_DEVICE( &PORTB, 2, SPI_CLOCK_RATE_FOSC_DIV_4, ... );
+ **/
+#define SPI_DEVICE( port, bit, rate, polarity, edge, sample )                  \
+        { { (port), (uint8_t)(1u << (bit)) },                                   \
+          (uint8_t)((uint8_t)(rate) | (uint8_t)(polarity)),                     \
+          (uint8_t)((uint8_t)(edge) | (uint8_t)(sample)) }
+
+/**
+ * Slave mode buffers (SPI_SlaveXxx routines), powers of two up to 128
+ **/
+#ifndef SPI_SLAVE_TX_SIZE
+#define SPI_SLAVE_TX_SIZE   16u     // responses waiting for the master
+#endif
+#ifndef SPI_SLAVE_RX_SIZE
+#define SPI_SLAVE_RX_SIZE   16u     // received bytes waiting for main
+#endif
+#ifndef SPI_SLAVE_FILL
+#define SPI_SLAVE_FILL      0xFFu   // sent when there is no response ready
+#endif
+
+/**
+ * Slave mode error counters (see SPI_SlaveGetStats)
+ **/
+typedef struct{
+    uint16_t overflow;          // SSPOV: a byte arrived before the ISR read the previous one (lost)
+    uint16_t collision;         // WCOL: the response was written after the master started the byte
+    uint16_t rxDropped;         // the receive buffer was full (lost)
+} spi_slave_stats_t;
+
+/**
+ * Routine called from the ISR at the end of a transaction
+ **/
+typedef void (*spi_callback_t)( void );
+
+/**
+ * Queued transaction
+ **/
+typedef struct{
+    const spi_device_t *dev;    // NULL: no chip select, current configuration
+    const uint8_t *tx;          // NULL: send 0xFF
+    uint8_t *rx;                // NULL: received bytes are dropped
+    uint8_t len;
+    spi_callback_t done;        // NULL: no callback
+} spi_transaction_t;
+
 
 /**
   Section: SPI Module APIs
@@ -173,7 +250,8 @@ inline bool SPI_IsBusy( void );
 
   @Description
     This routine is used to obtain the value stored on SPI buffer.
-    This routine wait until BF = 1
+    This routine wait the end of the queued transactions and until BF = 1
+  (call it after SPI_WriteByte: a byte read by the queue ISR clears BF).
 
   @Preconditions
     SPI_InitializeMaster() function should have been called before calling this function.
@@ -191,6 +269,295 @@ inline bool SPI_IsBusy( void );
  */
 uint8_t SPI_ReadByte( );
 
+/**
+  @Summary
+    Full duplex block transfer
+
+  @Description
+    Send len bytes from tx and store the received bytes on rx (rx can be
+  the same buffer that tx). Blocking routine: it waits the queue and the
+  previous byte, and returns when the last byte is received. SSPIE is
+  masked during the block and restored at the end.
+    The next byte is prepared while the current one is shifted and is
+  written to SSPBUF just after BF sets, so the gap between bytes is a few
+  instruction cycles.
+    The chip select is not changed.
+
+  @Param
+    tx - Bytes to send (NULL: send 0xFF)
+    rx - Buffer for the received bytes (NULL: dropped)
+    len - Amount of bytes
+
+  @Returns
+    false if a write collision (WCOL) was detected: a byte was lost, Ej: an
+  ISR wrote SSPBUF during the block.
+
+  @Comment
+    The bus limit is 8 cycles per byte with SPI_CLOCK_RATE_FOSC_DIV_4
+  (Fosc / 32 bytes/s), 32 with FOSC_DIV_16 and 128 with FOSC_DIV_64.
+    Every byte adds the gap from BF set to the SSPBUF write: the poll of BF
+  (up to 3 cycles), the bank select and the read and write of SSPBUF.
+  Estimate from a hand count of the loop instructions, not measured: about
+  8 cycles, so about 16 cycles per byte with FOSC_DIV_4 (half of the bus
+  rate), 40 with FOSC_DIV_16 and 136 with FOSC_DIV_64.
+    To measure it on the target enable the PROFILE_ID_SPI_BLOCK probe
+  (util/profile.h, Timer1 counts of every block routine): bytes/s =
+  len * (Fosc / 4) / counts (Timer1 prescaler 1:1).
+
+  @Example
+    <code>
+    uint8_t cmd[3] = { 0x03, 0x00, 0x10 };   // read at 0x0010
+    uint8_t data[16];
+    
+    CS = 0;
+    SPI_WriteBlock( cmd, 3 );
+    SPI_ReadBlock( data, 16, 0xFF );
+    CS = 1;
+    </code>
+*/
+bool SPI_Transfer( const uint8_t *tx, uint8_t *rx, uint8_t len );
+
+/**
+  @Summary
+    Send a block (the received bytes are dropped), see SPI_Transfer
+*/
+bool SPI_WriteBlock( const uint8_t *tx, uint8_t len );
+
+/**
+  @Summary
+    Receive a block sending 'fill' on every byte, see SPI_Transfer
+*/
+bool SPI_ReadBlock( uint8_t *rx, uint8_t len, uint8_t fill );
+
+/**
+  @Summary
+    Select a device
+
+  @Description
+    Wait the end of the bus activity (queue and last byte), configure the
+  MSSP for the device and drive its chip select low.
+    The last configuration is cached: the MSSP is reprogrammed (powered off
+  and on) only when the device needs a configuration different to the
+  current one, otherwise the cost is two compares. Devices with the same
+  mode and clock rate never reprogram the module.
+
+  @Preconditions
+    SPI_InitializeMaster() function should have been called before calling
+  this function. The chip select pin must be a digital output.
+
+  @Param
+    dev - Device to select
+
+  @Comment
+    Do not queue transactions between SPI_Begin and SPI_End: the queue
+  drives its own chip selects.
+    With cs.port = NULL only the configuration is done, so the device can be
+  used behind drivers that drive their own chip select (Ej: the SendCommand
+  hook of MCP4922_t).
+
+  @Example
+    <code>
+    static const spi_device_t flash = SPI_DEVICE( &PORTC, 0, SPI_CLOCK_RATE_FOSC_DIV_4,
+                                                  SPI_CLOCK_POLARITY_IDLE_LOW,
+                                                  SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK,
+                                                  SPI_INPUT_SAMPLING_PHASE_IN_MIDDLE );
+    
+    SPI_Begin( &flash );
+    SPI_WriteBlock( cmd, 4 );
+    SPI_ReadBlock( data, 16, 0xFF );
+    SPI_End( &flash );
+    </code>
+*/
+void SPI_Begin( const spi_device_t *dev );
+
+/**
+  @Summary
+    Wait the last byte and drive the chip select of the device high
+*/
+void SPI_End( const spi_device_t *dev );
+
+/**
+  @Summary
+    Enable the interrupt driven queue
+
+  @Description
+    Enable the SSP interrupt (SSPIE and PEIE). SPI_InterruptHandler must be
+  called from the ISR (ISR_SSP_HANDLER on interrupt_16f887_config.h) and GIE
+  must be set by the application.
+    The blocking routines (SPI_WriteByte, SPI_ReadByte and the block
+  routines) can still be used: they wait until the queue is empty and mask
+  SSPIE while their bytes are on the way (until the block ends, or until
+  the byte of SPI_WriteByte is read or waited), then restore it.
+    The routines that wait the queue (the blocking ones, SPI_Begin, SPI_End,
+  SPI_InitializeMaster, SPI_InitializeSlave and SPI_QueueTransfer when the
+  queue is idle) must not be called with GIE clear (Ej: inside
+  CRITICAL_ENTER) while a queued transaction is in progress: the queue
+  advances on the ISR and they would wait forever.
+
+  @Preconditions
+    SPI_InitializeMaster() function should have been called before calling this function.
+*/
+void SPI_QueueInitialize( void );
+
+/**
+  @Summary
+    Queue a write transaction
+
+  @Description
+    Queue the transaction and return, the bytes are sent from the SSP
+  interrupt: one interrupt per byte, the CPU does not wait the 8 SCK
+  periods. The chip select is driven low before the first byte and high
+  after the last one, then 'done' is called (from the ISR).
+    The buffer is not copied: it must not change until 'done' is called.
+
+  @Param
+    dev - Device (NULL: no chip select and current configuration). The
+  MSSP is configured for the device before the first byte when it needs
+  (see SPI_Begin), so devices with different modes can share the queue.
+    buf - Bytes to send
+    len - Amount of bytes (1 to 255)
+    done - Routine called at the end (NULL: none). It runs on the ISR, it
+  must be short and must not queue other transactions.
+
+  @Returns
+    false if the queue is full (SPI_QUEUE_SIZE transactions) or len is 0.
+
+  @Example
+    <code>
+    static const spi_device_t dac = SPI_DEVICE( &PORTB, 2, SPI_CLOCK_RATE_FOSC_DIV_4,
+                                                SPI_CLOCK_POLARITY_IDLE_LOW,
+                                                SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK,
+                                                SPI_INPUT_SAMPLING_PHASE_IN_MIDDLE );
+    static uint8_t frame[2];
+    
+    frame[0] = 0x30 | (value >> 8);
+    frame[1] = (uint8_t)value;
+    SPI_QueueWrite( &dac, frame, 2, NULL );
+    ...     // sample the ADC while the frame is sent
+    </code>
+*/
+bool SPI_QueueWrite( const spi_device_t *dev, const uint8_t *buf, uint8_t len, spi_callback_t done );
+
+/**
+  @Summary
+    Queue a full duplex transaction
+
+  @Description
+    Like SPI_QueueWrite, the byte received with every byte sent is stored
+  on rx (rx can be the same buffer that tx).
+
+  @Param
+    tx - Bytes to send (NULL: send 0xFF)
+    rx - Buffer for the received bytes (NULL: dropped)
+*/
+bool SPI_QueueTransfer( const spi_device_t *dev, const uint8_t *tx, uint8_t *rx, uint8_t len, spi_callback_t done );
+
+/**
+  @Summary
+    Return true while there are transactions in progress or queued
+*/
+bool SPI_QueueIsBusy( void );
+
+/**
+  @Summary
+    Initializes the MSSP on SPI Slave mode
+
+  @Description
+    Configure the pins (SCK and SDI inputs, SDO output, SS (RA5) digital
+  input when it is used), the MSSP as SPI slave and enable the SSP
+  interrupt (SSPIE and PEIE). SPI_SlaveInterruptHandler must be called from
+  the ISR (ISR_SSP_HANDLER on interrupt_16f887_config.h) and GIE must be set
+  by the application.
+    On every byte the ISR stores the received byte on the receive buffer
+  and loads the next response from the transmit buffer (SPI_SLAVE_FILL if
+  it is empty) before anything else, so the response is ready for the next
+  byte of the master. The master must leave a gap between bytes of the
+  interrupt latency (context save and dispatch) plus about 20 instruction
+  cycles, Ej: 10us at Fosc = 20MHz. The bytes lost by a shorter gap are
+  counted (see SPI_SlaveGetStats).
+    The first byte sent is the first one queued with SPI_SlaveWrite before
+  the initialization, or SPI_SLAVE_FILL if there is none.
+
+  @Param clkPolarity, clkEdge - SPI mode, the same of the master
+  @Param useSS - true: SS pin enabled, SDO is driven only while SS is low
+  and a high SS resets the byte in progress (needed for
+  SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK). false: SS is not used,
+  RA5 is free.
+
+  @Comment
+    The master routines must not be used on slave mode. The cached master
+  configuration is invalidated: the next SPI_Begin reprograms the MSSP.
+
+  @Example
+    <code>
+    SPI_InitializeSlave( SPI_CLOCK_POLARITY_IDLE_LOW,
+                         SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK, true );
+    INTCONbits.GIE = 1;
+    ...
+    if( SPI_SlaveRead( &cmd ) && cmd == CMD_READ_TEMP ){
+        SPI_SlaveWrite( temp >> 8 );
+        SPI_SlaveWrite( (uint8_t)temp );
+    }
+    </code>
+*/
+void SPI_InitializeSlave( SPI_CLOCK_POLARITY clkPolarity, SPI_OUTPUT_DATA_PHASE clkEdge, bool useSS );
+
+/**
+  @Summary
+    Queue a response byte (slave mode), false if the buffer is full
+*/
+bool SPI_SlaveWrite( uint8_t byte );
+
+/**
+  @Summary
+    Queue up to len response bytes (slave mode), return how many were queued
+*/
+uint8_t SPI_SlaveWriteBlock( const uint8_t *buf, uint8_t len );
+
+/**
+  @Summary
+    Read the oldest received byte (slave mode), false if there is none
+*/
+bool SPI_SlaveRead( uint8_t *byte );
+
+/**
+  @Summary
+    Amount of received bytes waiting to be read (slave mode)
+*/
+uint8_t SPI_SlaveAvailable( void );
+
+/**
+  @Summary
+    Copy the slave error counters (consistent copy, see spi_slave_stats_t)
+*/
+void SPI_SlaveGetStats( spi_slave_stats_t *stats );
+
+/**
+  @Summary
+    Clear the slave error counters
+*/
+void SPI_SlaveStatsClear( void );
+
+/**
+  @Summary
+    SSP interrupt handler of the slave mode
+
+  @Preconditions
+    Must be called from the interrupt routine when SSPIF is set (Ej: bound
+  as ISR_SSP_HANDLER on interrupt_16f887_config.h).
+*/
+void SPI_SlaveInterruptHandler( void );
+
+/**
+  @Summary
+    SSP interrupt handler of the queue
+
+  @Preconditions
+    Must be called from the interrupt routine when SSPIF is set (Ej: bound
+  as ISR_SSP_HANDLER on interrupt_16f887_config.h).
+*/
+void SPI_InterruptHandler( void );
+
  
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -0,0 +1,96 @@
+/**
+  TMR0 Driver File
+
+  @Author
+    Jose Guerra Carmenate.
+
+  @File Name
+    tmr0_16f887.c
+
+  @Summary
+    This is the driver implementation file for the Timer0 system tick using 
+  PIC16F887 MCU.
+
+  @Description
+    Compiler          :  XC8 2.00
+    MPLAB             :  MPLAB X 5.10
+*/
+
+#ifdef _16F887
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include <stdint.h>
+#include "tmr0_16f887.h"
+#include "../../util/utils.h"
+
+/**
+ Section: Local Vars
+*/
+
+static volatile uint32_t tmr0_ms;     // milliseconds counter
+
+/**
+  Section: TMR0 Module APIs
+*/
+
+void TMR0_Initialize( void ){
+    INTCONbits.T0IE = 0;
+    
+    // internal clock (T0CS = 0), prescaler assigned to Timer0 (PSA = 0)
+    BIT_InsertMask( OPTION_REG, 
+                    _OPTION_REG_T0CS_MASK | _OPTION_REG_PSA_MASK | _OPTION_REG_PS_MASK,
+                    TMR0_PS << _OPTION_REG_PS_POSN );
+    
+    tmr0_ms = 0u;
+    TMR0 = TMR0_RELOAD;
+    
+    INTCONbits.T0IF = 0;
+    INTCONbits.T0IE = 1;
+}
+
+void TMR0_InterruptHandler( void ){
+    // add the reload: the counts elapsed since the overflow are kept (the
+    // cleared prescaler and the 2 cycles inhibit are not, see the header)
+    TMR0 += TMR0_RELOAD;
+    INTCONbits.T0IF = 0;
+    
+    tmr0_ms++;
+    TMR0_TICK_HANDLER();
+}
+
+uint32_t TMR0_GetMillis( void ){
+    uint32_t ms;
+    
+    // the ISR can change the counter between the bytes reads
+    do{
+        ms = tmr0_ms;
+    }while( ms != tmr0_ms );
+    return ms;
+}
+
+uint32_t TMR0_GetMicros( void ){
+    uint32_t ms;
+    uint8_t counts;
+    
+    do{
+        ms = tmr0_ms;
+        counts = TMR0 - TMR0_RELOAD;    // counts since the last tick
+        if( INTCONbits.T0IF ){          // overflow not handled by the ISR
+            counts = TMR0;              // (interrupts disabled or just now)
+            ms++;
+        }
+        // retry if the ISR run between the reads
+    }while( (uint32_t)(ms - tmr0_ms) > 1u );
+    
+    // ms * 1000 = ms * 1024 - ms * 16 - ms * 8 (no multiply helper)
+    ms = (ms << 10) - (ms << 4) - (ms << 3);
+    return ms + (((uint32_t)counts * TMR0_US_PER_COUNT_Q8) >> 8);
+}
+
+#endif
+/**
+ End of File
+*/
@@ -0,0 +1,196 @@
+/**
+  TMR0 Driver API Header File for PIC16F887
+
+  @Author
+    Jose Guerra Carmenate
+
+  @File Name
+    tmr0_16f887.h
+
+  @Summary
+    This is the header file for the Timer0 system tick using PIC16F887 MCUs
+
+  @Description
+    This header file provides APIs for a 1ms system tick on Timer0, with a
+  monotonic millisecond and microsecond counter.
+    On every tick TMR0_TICK_HANDLER() is executed inside the ISR (by default
+  SWTIMER_Tick, see util/swtimer.h).
+    The prescaler is selected at compile time from _XTAL_FREQ. The period is
+  rounded to an integer amount of Timer0 counts (Ej: 20MHz -> 156 counts of
+  6.4us = 0.9984ms).
+    The tick is not exact: the ISR adds TMR0_RELOAD to TMR0, and a write of
+  TMR0 clears the prescaler (the cycles counted since the last increment,
+  0 to TMR0_PRESCALER - 1, fixed by the interrupt latency) and inhibits the
+  count for 2 cycles. Every tick is 2 to TMR0_PRESCALER + 1 instruction
+  cycles longer than TMR0_COUNTS counts:
+        _XTAL_FREQ  prescaler  counts  cycles/tick    drift
+        4MHz        1:4        250     1002 - 1005    +0.20% .. +0.50%
+        8MHz        1:8        250     2002 - 2009    +0.10% .. +0.45%
+        16MHz       1:16       250     4002 - 4017    +0.05% .. +0.43%
+        20MHz       1:32       156     4994 - 5025    -0.12% .. +0.50%
+  (up to 18 s/hour). TMR0_GetMillis and the software timers are time-outs,
+  not a clock: keep a wall clock on Timer1 with a 32.768kHz crystal.
+*/
+
+
+#ifndef TMR0_16f887_H
+#define TMR0_16f887_H
+
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include <stdint.h>
+#include "../../util/swtimer.h"
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+
+        
+/**
+  Section: Configuration Options
+*/
+
+/**
+ * Routine executed on every tick (inside the ISR). 
+ * Ej: do{ SWTIMER_Tick(); SCHED_Tick(); }while(0)
+ **/
+#ifndef TMR0_TICK_HANDLER
+#define TMR0_TICK_HANDLER()     SWTIMER_Tick()
+#endif
+
+/**
+  Section: Data Types Definitions
+*/
+
+// Instruction cycles per millisecond
+#define TMR0_CYCLES_PER_MS  ((_XTAL_FREQ) / 4000ul)        // usable on #if
+
+// smaller prescaler with a period of 256 counts or less
+#if   TMR0_CYCLES_PER_MS <= 512ul
+#define TMR0_PS 0u
+#elif TMR0_CYCLES_PER_MS <= 1024ul
+#define TMR0_PS 1u
+#elif TMR0_CYCLES_PER_MS <= 2048ul
+#define TMR0_PS 2u
+#elif TMR0_CYCLES_PER_MS <= 4096ul
+#define TMR0_PS 3u
+#elif TMR0_CYCLES_PER_MS <= 8192ul
+#define TMR0_PS 4u
+#elif TMR0_CYCLES_PER_MS <= 16384ul
+#define TMR0_PS 5u
+#elif TMR0_CYCLES_PER_MS <= 32768ul
+#define TMR0_PS 6u
+#else
+#define TMR0_PS 7u
+#endif
+
+// prescaler value (2^(PS+1))
+#define TMR0_PRESCALER      (2ul << TMR0_PS)
+
+// Timer0 counts per tick, rounded to the nearest (error below half count,
+// Ej: none at 4MHz and 8MHz, -0.16% at 20MHz), plus the reload drift above
+#define TMR0_COUNTS_VALUE   \
+        (((_XTAL_FREQ) + 2000ul * TMR0_PRESCALER) / (4000ul * TMR0_PRESCALER))
+#define TMR0_COUNTS         ((uint16_t)TMR0_COUNTS_VALUE)
+#define TMR0_RELOAD         ((uint8_t)(256u - TMR0_COUNTS))
+
+// microseconds per count, Q8.8 (prescaler * 4 / MHz): prescaler * 256 * 40000
+// stays below 2^32 with any prescaler, _XTAL_FREQ / 100 keeps the precision
+// of low frequencies
+#define TMR0_US_PER_COUNT_Q8 \
+        (((TMR0_PRESCALER * 256ul) * 40000ul) / ((_XTAL_FREQ) / 100ul))
+
+#if TMR0_COUNTS_VALUE < 1ul || TMR0_COUNTS_VALUE > 256ul
+#error "TMR0: _XTAL_FREQ out of range for a 1ms tick"
+#endif
+#if TMR0_US_PER_COUNT_Q8 > 0xFFFFul
+#error "TMR0: _XTAL_FREQ too low for TMR0_GetMicros (more than 256us per count)"
+#endif
+
+
+/**
+  Section: TMR0 Module APIs
+*/
+
+/**
+  @Summary
+    Start the 1ms system tick
+
+  @Description
+    Configure Timer0 (internal clock, prescaler TMR0_PRESCALER), clear the
+  counters and enable the Timer0 interrupt.
+    The global interrupts (GIE) are not changed.
+
+  @Preconditions
+    None
+
+  @Param
+    None
+
+  @Returns
+    None
+
+  @Example
+    <code>
+    TMR0_Initialize();
+    INTCONbits.GIE = 1;
+    </code>
+*/
+void TMR0_Initialize( void );
+
+/**
+  @Summary
+    Timer0 interrupt handler
+
+  @Description
+    Reload Timer0, count the millisecond and execute TMR0_TICK_HANDLER().
+
+  @Preconditions
+    Must be called from the interrupt routine when T0IF is set. It is the
+  default ISR_TMR0_HANDLER of the interrupt dispatcher
+  (interrupt_16f887_config.h).
+
+  @Example
+    <code>
+    void __interrupt() isr( void ){
+        ISR_DISPATCH();     // or: if( INTCONbits.T0IF ) TMR0_InterruptHandler();
+    }
+    </code>
+*/
+void TMR0_InterruptHandler( void );
+
+/**
+  @Summary
+    Milliseconds since TMR0_Initialize
+
+  @Description
+    Monotonic counter, wraps around after 49 days.
+*/
+uint32_t TMR0_GetMillis( void );
+
+/**
+  @Summary
+    Microseconds since TMR0_Initialize
+
+  @Description
+    Monotonic counter with resolution of one Timer0 count (Ej: 6.4us at
+  20MHz), wraps around after 71 minutes.
+    It can be called with the interrupts enabled or disabled.
+*/
+uint32_t TMR0_GetMicros( void );
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+
+#endif	//TMR0_16f887_H 
+/**
+ End of File
+*/
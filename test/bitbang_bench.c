@@ -0,0 +1,271 @@
+/*
+ * File:   bitbang_bench.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Operation count benchmark of util/bitbang against the rolled loops it
+ * replaced on the HCMS-29xx and 595 lite drivers. The pins are host
+ * variables: the harness counts, for every byte value, the operations of
+ * one byte:
+ *  - wr: pin writes
+ *  - tst: bit tests of the byte that select the data pin write (every data
+ *    write of these routines is a bit of the byte)
+ *  - shf: one bit shifts of the byte (a shift by j is j steps)
+ *  - lp: steps of the bit loop counter
+ *  - dly: runs of the delay statements
+ *  The cycles column weights them with the shortest PIC16/PIC12 code of
+ * each operation, it is a model, not a measurement on the target:
+ *  - wr 1: BSF or BCF
+ *  - tst 3: BTFSC/BSF, BTFSS/BCF is 4 cycles with its write, for the
+ *    bit copy of the loops (pin = byte & 1) and for the if/else of bitbang
+ *  - shf 2: CLRC, RRF or RLF (the cyclic shift of the 595 loop is RLF, RLF)
+ *  - lp 5: DECF, INCF W (compare with 255), BTFSS Z, GOTO
+ *  - the empty delays of the default configurations, 0
+ *  The loop of a variable shift (HCMS) is not counted, only its shifts.
+ *  The data pin is sampled on every rising edge of the clock: the bit
+ * order of every routine is checked on the 256 values (exit status != 0
+ * on failure).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "bitbang.h"
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+static struct{
+    uint32_t write;
+    uint32_t test;
+    uint32_t shift;
+    uint32_t loop;
+    uint32_t delay;
+} stats;
+
+static uint8_t pin_data;
+static uint8_t pin_clk;
+
+static uint8_t sampled;         // bits sampled on the rising edges
+static uint8_t sampledCount;
+
+static unsigned long fails;
+
+/******************************************************************************
+ ************************ Section: Mock pins **********************************
+ ******************************************************************************/
+
+/**
+ * A pin write: 'PIN_DATA = x' counts one write, and one bit test on the
+ * data pin
+ **/
+static uint8_t *bb_pin( uint8_t *pin ){
+    stats.write++;
+    if( pin == &pin_data )
+        stats.test++;
+    return pin;
+}
+
+#define PIN_DATA        (*bb_pin( &pin_data ))
+#define PIN_CLK         (*bb_pin( &pin_clk ))
+
+/**
+ * The delay statement, it runs after the clock edges: sample the data pin
+ * while the clock is high (after the rising edge)
+ **/
+static void bb_delay( void ){
+    stats.delay++;
+    if( pin_clk ){
+        sampled = (uint8_t)((sampled << 1) | (pin_data & 1u));
+        sampledCount++;
+    }
+}
+
+#define BB_DELAY        bb_delay()
+
+/******************************************************************************
+ ******************* Section: Routines before util/bitbang ********************
+ ******************************************************************************/
+
+/**
+ * 595 lite: ShiftReg595_SendByteLSBFirst (the delay ran after the rising
+ * edge only)
+ **/
+static void old595_SendByteLSBFirst( uint8_t byte ){
+    uint8_t l = 7;
+    while( l != 255 ){
+        PIN_DATA = byte & 0x01;
+        PIN_CLK = 1;
+        BB_DELAY;
+        PIN_CLK = 0;
+        byte >>= 1;             stats.shift++;
+        l--;                    stats.loop++;
+    }
+}
+
+/**
+ * 595 lite: ShiftReg595_SendByteMSBFirst (cyclic left-shift)
+ **/
+static void old595_SendByteMSBFirst( uint8_t byte ){
+    uint8_t l = 7;
+    while( l != 255 ){
+        byte = (uint8_t)((byte<<1) | ( (byte&0x80)?0x01:0x00 ));
+        stats.shift++;
+        PIN_DATA = byte & 0x01;
+        PIN_CLK = 1;
+        BB_DELAY;
+        PIN_CLK = 0;
+        l--;                    stats.loop++;
+    }
+}
+
+/**
+ * HCMS-29xx lite: the bit loop of LedDisplay_LoadControlRegister and
+ * LedDisplay_PutUserChar (variable shift by j: a loop on the PIC)
+ **/
+static void oldHcms_SendByte( uint8_t b ){
+    for( uint8_t j = 7u; j != 255u; j-- ){
+        PIN_DATA = (b>>j)&0x01u;
+        stats.shift += j;
+        PIN_CLK = 1u;
+        BB_DELAY;
+        PIN_CLK = 0u;
+        BB_DELAY;
+        stats.loop++;
+    }
+}
+
+/******************************************************************************
+ ************************* Section: util/bitbang ******************************
+ ******************************************************************************/
+
+/**
+ * 595 lite: delay on the high time only, as the loops
+ **/
+static void new595_SendByteLSBFirst( uint8_t byte ){
+    BITBANG_SEND_LSB_FIRST( PIN_DATA, PIN_CLK, BB_DELAY, , byte );
+}
+
+static void new595_SendByteMSBFirst( uint8_t byte ){
+    BITBANG_SEND_MSB_FIRST( PIN_DATA, PIN_CLK, BB_DELAY, , byte );
+}
+
+/**
+ * HCMS-29xx lite: CLK_DELAY on both times, through BITBANG_DEFINE
+ **/
+BITBANG_DEFINE( newHcms_SendByte, MSB_FIRST, PIN_DATA, PIN_CLK, BB_DELAY, BB_DELAY )
+
+/******************************************************************************
+ ***************************** Section: Bench *********************************
+ ******************************************************************************/
+
+/**
+ * Workload ids
+ **/
+enum{
+    W_OLD_595_LSB,
+    W_NEW_595_LSB,
+    W_OLD_595_MSB,
+    W_NEW_595_MSB,
+    W_OLD_HCMS,
+    W_NEW_HCMS,
+    W_COUNT
+};
+
+static const char *names[W_COUNT] = {
+    "595 LSB first  loop", "595 LSB first  bitbang",
+    "595 MSB first  loop", "595 MSB first  bitbang",
+    "HCMS MSB first loop", "HCMS MSB first bitbang"
+};
+
+static void (* const routines[W_COUNT])( uint8_t ) = {
+    old595_SendByteLSBFirst, new595_SendByteLSBFirst,
+    old595_SendByteMSBFirst, new595_SendByteMSBFirst,
+    oldHcms_SendByte, newHcms_SendByte
+};
+
+typedef struct{
+    unsigned long calls;
+    unsigned long long sum[5];
+    uint32_t max[5];
+    unsigned long long cycles;
+} result_t;
+
+static result_t results[W_COUNT];
+
+/**
+ * Reverse the bit order of b
+ **/
+static uint8_t reverse( uint8_t b ){
+    uint8_t r = 0, i;
+
+    for( i = 0; i < 8u; i++ )
+        r = (uint8_t)((r << 1) | ((b >> i) & 1u));
+    return r;
+}
+
+/**
+ * Send b with workload w, check the bit order and record its counters
+ **/
+static void run( uint8_t w, uint8_t b ){
+    result_t *r = &results[w];
+    uint8_t lsbFirst = (w == W_OLD_595_LSB || w == W_NEW_595_LSB);
+    uint8_t expected = lsbFirst ? reverse( b ) : b;
+    uint32_t c[5];
+    uint8_t i;
+
+    memset( &stats, 0, sizeof stats );
+    pin_clk = 0;
+    sampled = 0;
+    sampledCount = 0;
+    routines[w]( b );
+
+    if( sampledCount != 8u || sampled != expected || pin_clk != 0u ){
+        if( fails++ < 20u )
+            printf( "FAIL %s( 0x%02X ): sent 0x%02X (%u bits) expected 0x%02X\n",
+                    names[w], b, sampled, sampledCount, expected );
+    }
+
+    c[0] = stats.write;
+    c[1] = stats.test;
+    c[2] = stats.shift;
+    c[3] = stats.loop;
+    c[4] = stats.delay;
+    r->calls++;
+    for( i = 0; i < 5u; i++ ){
+        r->sum[i] += c[i];
+        if( c[i] > r->max[i] )
+            r->max[i] = c[i];
+    }
+    r->cycles += c[0] + 3u*c[1] + 2u*c[2] + 5u*c[3];
+}
+
+int main( void ){
+    uint32_t x;
+    uint8_t w, i;
+
+    for( x = 0; x < 256u; x++ )
+        for( w = 0; w < W_COUNT; w++ )
+            run( w, (uint8_t)x );
+
+    printf( "bitbang operation counts per byte\n" );
+    printf( "%-24s %6s %11s %11s %11s %11s %11s %8s %6s\n", "routine", "calls",
+            "wr avg/max", "tst avg/max", "shf avg/max", "lp avg/max", "dly avg/max",
+            "cycles", "gain" );
+    for( w = 0; w < W_COUNT; w++ ){
+        result_t *r = &results[w];
+        double cycles = (double)r->cycles / r->calls;
+
+        printf( "%-24s %6lu", names[w], r->calls );
+        for( i = 0; i < 5u; i++ )
+            printf( " %6.2f/%-4lu", (double)r->sum[i] / r->calls, (unsigned long)r->max[i] );
+        printf( " %8.2f", cycles );
+        if( w & 1u )
+            printf( " %5.2fx", (double)results[w - 1u].cycles / r->cycles );
+        printf( "\n" );
+    }
+    printf( "bit order: %lu failures\n", fails );
+    return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
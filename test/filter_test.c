@@ -0,0 +1,209 @@
+/*
+ * File:   filter_test.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Host (PC) checks of util/filter against references:
+ *  - FILTER_Median3 and FILTER_Median5 on every tuple of 3 and 5 values
+ *    from 0 to 4 (every permutation, with and without repeated values), and
+ *    on random 16 bits values, against a sort
+ *  - FILTER_MedianPut against the sorted window of the last
+ *    FILTER_MEDIAN_SIZE samples (built for 3 and 5, see test/Makefile)
+ *  - FILTER_AvgPut against the sum of the last 2^shift samples
+ *  - FILTER_IirPut against the double precision recurrence (the truncation
+ *    error is bounded by 1), and its settle on constant inputs
+ *  - FILTER_MinMaxPut against a scan of the samples
+ *  The samples are 10 bits with windows and gains up to 2^6 (the 16 bits
+ * sum limit of filter.h).
+ *  Exit status 0 when every check passes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "filter.h"
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+static unsigned long checks;
+static unsigned long fails;
+
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+/**
+ * Reproducible random numbers (xorshift32)
+ **/
+static uint32_t rnd_state = 0x12345678u;
+
+static uint32_t rnd( void ){
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+/**
+ * Record a check, print the first failures
+ **/
+static void check( const char *what, long arg, long got, long exp ){
+    checks++;
+    if( got == exp )
+        return;
+    if( fails++ < 20u )
+        printf( "FAIL %s( %ld ): got %ld expected %ld\n", what, arg, got, exp );
+}
+
+/**
+ * Reference median: insertion sort of a copy of the n values
+ **/
+static uint16_t ref_median( const uint16_t *p, uint8_t n ){
+    uint16_t v[5];
+    uint8_t i, j;
+
+    for( i = 0; i < n; i++ ){
+        uint16_t x = p[i];
+
+        for( j = i; j > 0u && v[j - 1u] > x; j-- )
+            v[j] = v[j - 1u];
+        v[j] = x;
+    }
+    return v[n / 2u];
+}
+
+/******************************************************************************
+ ***************************** Section: Checks ********************************
+ ******************************************************************************/
+
+/**
+ * Sorting networks
+ **/
+static void test_networks( void ){
+    uint16_t v[5];
+    long i, k;
+
+    for( i = 0; i < 125; i++ ){             // 5^3 tuples
+        v[0] = (uint16_t)(i % 5);
+        v[1] = (uint16_t)((i / 5) % 5);
+        v[2] = (uint16_t)(i / 25);
+        check( "FILTER_Median3", i, FILTER_Median3( v[0], v[1], v[2] ), ref_median( v, 3u ) );
+    }
+    for( i = 0; i < 3125; i++ ){            // 5^5 tuples
+        long x = i;
+
+        for( k = 0; k < 5; k++, x /= 5 )
+            v[k] = (uint16_t)(x % 5);
+        check( "FILTER_Median5", i, FILTER_Median5( v ), ref_median( v, 5u ) );
+    }
+    for( i = 0; i < 200000; i++ ){
+        for( k = 0; k < 5; k++ )
+            v[k] = (uint16_t)rnd();
+        check( "FILTER_Median3", i, FILTER_Median3( v[0], v[1], v[2] ), ref_median( v, 3u ) );
+        check( "FILTER_Median5", i, FILTER_Median5( v ), ref_median( v, 5u ) );
+    }
+}
+
+/**
+ * Median, moving average and min/max filters on random 10 bits samples
+ **/
+static void test_steps( void ){
+    static uint16_t samples[4096];
+    static uint16_t buffer[64];
+    filter_median_t med;
+    filter_avg_t avg;
+    filter_minmax_t mm;
+    uint8_t shift;
+    long i, k, start;
+
+    for( i = 0; i < 4096; i++ )             // spikes and flat runs
+        samples[i] = (rnd() & 7u) ? (uint16_t)(rnd() & 0x3FFu)
+                                  : (uint16_t)(i ? samples[i - 1] : 0u);
+
+    // the window starts with 'initial' samples (index < 0)
+    FILTER_MedianInitialize( &med, 512u );
+    for( i = 0; i < 4096; i++ ){
+        uint16_t w[FILTER_MEDIAN_SIZE];
+
+        for( k = 0; k < (long)FILTER_MEDIAN_SIZE; k++ )
+            w[k] = (i - k >= 0) ? samples[i - k] : 512u;
+        check( "FILTER_MedianPut", i, FILTER_MedianPut( &med, samples[i] ),
+               ref_median( w, FILTER_MEDIAN_SIZE ) );
+    }
+
+    for( shift = 0u; shift <= 6u; shift++ ){
+        FILTER_AvgInitialize( &avg, buffer, shift, 100u );
+        for( i = 0; i < 4096; i++ ){
+            long sum = 0;
+
+            for( k = 0; k < (1l << shift); k++ )
+                sum += (i - k >= 0) ? samples[i - k] : 100;
+            check( "FILTER_AvgPut", i, FILTER_AvgPut( &avg, samples[i] ), sum >> shift );
+        }
+    }
+
+    // a new tracking every 1024 samples
+    for( i = 0, start = 0; i < 4096; i++ ){
+        uint16_t lo = 0xFFFFu, hi = 0u;
+
+        if( (i & 1023) == 0 ){
+            FILTER_MinMaxReset( &mm );
+            start = i;
+        }
+        FILTER_MinMaxPut( &mm, samples[i] );
+        for( k = start; k <= i; k++ ){
+            if( samples[k] < lo )
+                lo = samples[k];
+            if( samples[k] > hi )
+                hi = samples[k];
+        }
+        check( "FILTER_MinMaxPut min", i, mm.min, lo );
+        check( "FILTER_MinMaxPut max", i, mm.max, hi );
+    }
+}
+
+/**
+ * IIR: error against the exact recurrence, and settle on constant inputs
+ **/
+static void test_iir( void ){
+    filter_iir_t f;
+    uint8_t shift;
+    long i;
+
+    for( shift = 0u; shift <= 6u; shift++ ){
+        double y = 0.0;
+
+        FILTER_IirInitialize( &f, shift, 0u );
+        for( i = 0; i < 20000; i++ ){
+            uint16_t x = (rnd() & 3u) ? (uint16_t)(rnd() & 0x3FFu) : 1023u;
+            long got = FILTER_IirPut( &f, x );
+
+            y += ( x - y ) / (double)(1ul << shift);
+            check( "FILTER_IirPut |error| <= 1", i, fabs( got - y ) < 1.0 + 1e-9, 1 );
+        }
+
+        // a constant input is reached exactly (steps from both sides)
+        for( i = 0; i < 64l << shift; i++ )
+            (void)FILTER_IirPut( &f, 700u );
+        check( "FILTER_IirPut settle", shift, FILTER_IirPut( &f, 700u ), 700 );
+        for( i = 0; i < 64l << shift; i++ )
+            (void)FILTER_IirPut( &f, 3u );
+        check( "FILTER_IirPut settle down", shift, FILTER_IirPut( &f, 3u ), 3 );
+        for( i = 0; i < 64l << shift; i++ )
+            (void)FILTER_IirPut( &f, 1023u );
+        check( "FILTER_IirPut settle up", shift, FILTER_IirPut( &f, 1023u ), 1023 );
+    }
+}
+
+int main( void ){
+    test_networks();
+    test_steps();
+    test_iir();
+
+    printf( "filter (FILTER_MEDIAN_SIZE=%u): %lu checks, %lu failures\n",
+            (unsigned)FILTER_MEDIAN_SIZE, checks, fails );
+    return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
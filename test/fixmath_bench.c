@@ -0,0 +1,134 @@
+/*
+ * File:   fixmath_bench.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Step count benchmark of util/fixmath (built with FIXMATH_STATS=1, see
+ * test/Makefile). For every routine it prints the average and maximum of
+ * the fixmath_stats counters per call:
+ *  - mul: 8x8 multiply add steps
+ *  - div: shift-and-subtract steps
+ *  - sqrt: square root steps
+ *  The operands are random values with a random amount of significant bits
+ * (small and large values, as on sensor scaling).
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "fixmath.h"
+
+#if FIXMATH_STATS != 1
+#error "build with -DFIXMATH_STATS=1"
+#endif
+
+/**
+ * Reproducible random numbers (xorshift32)
+ **/
+static uint32_t rnd_state = 0x12345678u;
+
+static uint32_t rnd( void ){
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+/**
+ * Random signed value with a random amount of significant bits (1 to 32)
+ **/
+static int32_t rnd_signed( void ){
+    return (int32_t)rnd() >> (rnd() % 32u);
+}
+
+/**
+ * The same on 16 bits (1 to 16 significant bits)
+ **/
+static int16_t rnd_signed16( void ){
+    return (int16_t)((int16_t)rnd() >> (rnd() % 16u));
+}
+
+/**
+ * Workload ids
+ **/
+enum{
+    W_MUL8_8,
+    W_DIV8_8,
+    W_MUL16_16,
+    W_DIV16_16,
+    W_RECIP16_16,
+    W_ISQRT,
+    W_SQRT8_8,
+    W_COUNT
+};
+
+static const char *names[W_COUNT] = {
+    "FIX_Mul8_8", "FIX_Div8_8", "FIX_Mul16_16", "FIX_Div16_16",
+    "FIX_Recip16_16", "FIX_ISqrt", "FIX_Sqrt8_8"
+};
+
+typedef struct{
+    unsigned long calls;
+    unsigned long long sum[3];
+    uint32_t max[3];
+} result_t;
+
+static result_t results[W_COUNT];
+
+/**
+ * Run one call of workload w and record its counters
+ **/
+static void run( uint8_t w, int32_t a, int32_t b ){
+    result_t *r = &results[w];
+    uint32_t c[3];
+    uint8_t i;
+
+    memset( &fixmath_stats, 0, sizeof fixmath_stats );
+    switch( w ){
+        case W_MUL8_8:      (void)FIX_Mul8_8( (q8_8_t)a, (q8_8_t)b ); break;
+        case W_DIV8_8:      (void)FIX_Div8_8( (q8_8_t)a, (q8_8_t)b ); break;
+        case W_MUL16_16:    (void)FIX_Mul16_16( a, b ); break;
+        case W_DIV16_16:    (void)FIX_Div16_16( a, b ); break;
+        case W_RECIP16_16:  (void)FIX_Recip16_16( a ); break;
+        case W_ISQRT:       (void)FIX_ISqrt( (uint32_t)a ); break;
+        case W_SQRT8_8:     (void)FIX_Sqrt8_8( (q8_8_t)a ); break;
+        default: break;
+    }
+    c[0] = fixmath_stats.mul;
+    c[1] = fixmath_stats.div;
+    c[2] = fixmath_stats.sqrt;
+    r->calls++;
+    for( i = 0; i < 3u; i++ ){
+        r->sum[i] += c[i];
+        if( c[i] > r->max[i] )
+            r->max[i] = c[i];
+    }
+}
+
+int main( void ){
+    uint8_t w, i;
+    long n;
+
+    for( n = 0; n < 300000; n++ ){
+        run( W_MUL8_8, rnd_signed16(), rnd_signed16() );
+        run( W_DIV8_8, rnd_signed16(), rnd_signed16() );
+        run( W_SQRT8_8, rnd_signed16(), 0 );
+        run( W_MUL16_16, rnd_signed(), rnd_signed() );
+        run( W_DIV16_16, rnd_signed(), rnd_signed() );
+        run( W_RECIP16_16, rnd_signed(), 0 );
+        run( W_ISQRT, (int32_t)(rnd() >> (rnd() % 32u)), 0 );
+    }
+
+    printf( "fixmath step counts per call\n" );
+    printf( "%-16s %8s %13s %13s %13s\n", "routine", "calls",
+            "mul avg/max", "div avg/max", "sqrt avg/max" );
+    for( w = 0; w < W_COUNT; w++ ){
+        result_t *r = &results[w];
+
+        printf( "%-16s %8lu", names[w], r->calls );
+        for( i = 0; i < 3u; i++ )
+            printf( " %8.2f/%-4lu", (double)r->sum[i] / r->calls, (unsigned long)r->max[i] );
+        printf( "\n" );
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * File:   fixmath_test.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Host (PC) checks of util/fixmath against a double precision reference
+ * (rounded to nearest, ties away from zero, and saturated):
+ *  - FIX_Mul8x8 on every pair of values, FIX_Mul16x16 on random values
+ *  - Q8.8 and Q16.16 multiply, divide, saturating add and reciprocal on
+ *    random values with a random amount of significant bits, and limits
+ *  - FIX_ISqrt and FIX_Sqrt8_8, FIX_Lerp and FIX_Interpolate
+ *  Exit status 0 when every check passes (see test/Makefile).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "fixmath.h"
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+static unsigned long checks;
+static unsigned long fails;
+
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+/**
+ * Reproducible random numbers (xorshift32)
+ **/
+static uint32_t rnd_state = 0x12345678u;
+
+static uint32_t rnd( void ){
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+/**
+ * Random signed value with a random amount of significant bits (1 to 32),
+ * so small operands and saturated results are both checked
+ **/
+static int32_t rnd_signed( void ){
+    return (int32_t)rnd() >> (rnd() % 32u);
+}
+
+/**
+ * The same on 16 bits (1 to 16 significant bits)
+ **/
+static int16_t rnd_signed16( void ){
+    return (int16_t)((int16_t)rnd() >> (rnd() % 16u));
+}
+
+/**
+ * Record a check, print the first failures. 'tol' is the accepted error.
+ **/
+static void check( const char *what, long a, long b, double got, double exp, double tol ){
+    checks++;
+    if( fabs( got - exp ) <= tol )
+        return;
+    if( fails++ < 20u )
+        printf( "FAIL %s( %ld, %ld ): got %.0f expected %.3f\n", what, a, b, got, exp );
+}
+
+/**
+ * Reference: v rounded to nearest and saturated to lo .. hi
+ **/
+static double ref( double v, double lo, double hi ){
+    v = round( v );
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+#define REF8( v )       ref( (v), -32768.0, 32767.0 )
+#define REF16( v )      ref( (v), -2147483648.0, 2147483647.0 )
+
+/******************************************************************************
+ ***************************** Section: Checks ********************************
+ ******************************************************************************/
+
+/**
+ * Unsigned products
+ **/
+static void test_products( void ){
+    uint32_t a, b;
+    long i;
+
+    for( a = 0u; a < 256u; a++ )
+        for( b = 0u; b < 256u; b++ )
+            check( "FIX_Mul8x8", (long)a, (long)b, FIX_Mul8x8( (uint8_t)a, (uint8_t)b ),
+                   (double)a * b, 0.0 );
+    for( i = 0; i < 200000; i++ ){
+        a = rnd() & 0xFFFFu;
+        b = rnd() & 0xFFFFu;
+        check( "FIX_Mul16x16", (long)a, (long)b, FIX_Mul16x16( (uint16_t)a, (uint16_t)b ),
+               (double)a * b, 0.0 );
+    }
+}
+
+/**
+ * Q8.8 routines
+ **/
+static void test_q8_8( void ){
+    long i;
+
+    for( i = 0; i < 300000; i++ ){
+        q8_8_t a = rnd_signed16();
+        q8_8_t b = rnd_signed16();
+
+        check( "FIX_Mul8_8", a, b, FIX_Mul8_8( a, b ), REF8( (double)a * b / 256.0 ), 0.0 );
+        if( b )
+            check( "FIX_Div8_8", a, b, FIX_Div8_8( a, b ), REF8( (double)a * 256.0 / b ), 0.0 );
+        check( "FIX_AddSat8_8", a, b, FIX_AddSat8_8( a, b ), REF8( (double)a + b ), 0.0 );
+        if( a )
+            check( "FIX_Recip8_8", a, 0, FIX_Recip8_8( a ), REF8( 65536.0 / a ), 0.0 );
+    }
+    for( i = 0; i <= 32767; i++ )
+        check( "FIX_Sqrt8_8", i, 0, FIX_Sqrt8_8( (q8_8_t)i ), round( sqrt( i / 256.0 ) * 256.0 ), 0.0 );
+    check( "FIX_Sqrt8_8", -256, 0, FIX_Sqrt8_8( -256 ), 0.0, 0.0 );
+    check( "FIX_Div8_8", 100, 0, FIX_Div8_8( 100, 0 ), 32767.0, 0.0 );
+    check( "FIX_Div8_8", -100, 0, FIX_Div8_8( -100, 0 ), -32768.0, 0.0 );
+    check( "FIX_Mul8_8", INT16_MIN, 256, FIX_Mul8_8( INT16_MIN, FIX_Q8_8( 1.0 ) ), -32768.0, 0.0 );
+    check( "FIX_Mul8_8", INT16_MIN, INT16_MIN, FIX_Mul8_8( INT16_MIN, INT16_MIN ), 32767.0, 0.0 );
+    check( "FIX_Recip8_8", 512, 0, FIX_Recip8_8( FIX_Q8_8( 2.0 ) ), 128.0, 0.0 );
+}
+
+/**
+ * Q16.16 routines and the integer square root
+ **/
+static void test_q16_16( void ){
+    long i;
+
+    for( i = 0; i < 300000; i++ ){
+        q16_16_t a = rnd_signed();
+        q16_16_t b = rnd_signed();
+        uint32_t u = rnd() >> (rnd() % 32u);
+
+        check( "FIX_Mul16_16", a, b, FIX_Mul16_16( a, b ), REF16( (double)a * b / 65536.0 ), 0.0 );
+        if( b )
+            check( "FIX_Div16_16", a, b, FIX_Div16_16( a, b ), REF16( (double)a * 65536.0 / b ), 0.0 );
+        check( "FIX_AddSat16_16", a, b, FIX_AddSat16_16( a, b ), REF16( (double)a + b ), 0.0 );
+        if( a )
+            check( "FIX_Recip16_16", a, 0, FIX_Recip16_16( a ), REF16( 4294967296.0 / a ), 0.0 );
+        check( "FIX_ISqrt", (long)u, 0, FIX_ISqrt( u ), floor( sqrt( (double)u ) ), 0.0 );
+    }
+    check( "FIX_ISqrt", 0xFFFFFFFFl, 0, FIX_ISqrt( 0xFFFFFFFFul ), 65535.0, 0.0 );
+    check( "FIX_Div16_16", 1, 0, FIX_Div16_16( 1, 0 ), 2147483647.0, 0.0 );
+    check( "FIX_Div16_16", -1, 0, FIX_Div16_16( -1, 0 ), -2147483648.0, 0.0 );
+    check( "FIX_Mul16_16", INT32_MIN, INT32_MIN, FIX_Mul16_16( INT32_MIN, INT32_MIN ), 2147483647.0, 0.0 );
+    check( "FIX_Recip16_16", 32768, 0, FIX_Recip16_16( FIX_Q16_16( 0.5 ) ), 131072.0, 0.0 );
+}
+
+/**
+ * Interpolation (the reference is not rounded: accept half unit)
+ **/
+static void test_interpolation( void ){
+    static const int16_t table[17] = {
+        -400, -300, -150, 0, 100, 500, 1000, -2000, 32767, -32768, 0, 1, 2, 3, 4, 5, 6
+    };
+    long a, b, t, x;
+
+    for( a = -30000; a <= 30000; a += 701 )
+        for( b = -30000; b <= 30000; b += 977 )
+            for( t = 0; t <= 256; t += 5 )
+                check( "FIX_Lerp", a, b, FIX_Lerp( (int16_t)a, (int16_t)b, (uint16_t)t ),
+                       a + (double)(b - a) * t / 256.0, 0.5 );
+    for( x = 0; x < 1100; x++ ){
+        long i = x >> 6;
+        double e = (i >= 16) ? table[16]
+                             : table[i] + (double)(table[i + 1] - table[i]) * (x & 63) / 64.0;
+
+        check( "FIX_Interpolate", x, 0, FIX_Interpolate( table, 17u, (uint16_t)x, 6u ), e, 0.5 );
+    }
+}
+
+int main( void ){
+    test_products();
+    test_q8_8();
+    test_q16_16();
+    test_interpolation();
+
+    printf( "fixmath: %lu checks, %lu failures\n", checks, fails );
+    return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
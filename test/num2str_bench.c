@@ -0,0 +1,157 @@
+/*
+ * File:   num2str_bench.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Operation count benchmark of util/num2str (built with NUM2STR_STATS=1,
+ * see test/Makefile). For every workload it prints the average and maximum
+ * of the num2str_stats counters per conversion:
+ *  - sub: compare-and-subtract steps (decimal digit extraction)
+ *  - div: shift-and-subtract division steps (generic bases)
+ *  - shf: shift steps (power of two bases)
+ *  - put: characters put
+ *  The PIC16 has no divider and no multiplier, so these steps are the cost
+ * of a conversion: compare the output of a change with the output before it.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "num2str.h"
+
+#if NUM2STR_STATS != 1
+#error "build with -DNUM2STR_STATS=1"
+#endif
+
+/**
+ * Reproducible random numbers (xorshift32)
+ **/
+static uint32_t rnd_state = 0x12345678u;
+
+static uint32_t rnd( void ){
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+/**
+ * Random value with a random amount of significant bits (1 to 32)
+ **/
+static uint32_t rnd_bits( void ){
+    return rnd() >> (rnd() % 32u);
+}
+
+/**
+ * Workload ids
+ **/
+enum{
+    W_UINT8_DEC,        // ushort2str base 10, every value
+    W_UINT16_DEC,       // uint2str base 10, every value
+    W_INT16_DEC,        // int2str base 10, every value
+    W_UINT16_ADC,       // uint2str base 10, 0 .. 1023 (10 bits ADC readings)
+    W_UINT32_DEC,       // ulong2str base 10, uniform 32 bits values
+    W_UINT32_DEC_BITS,  // ulong2str base 10, random amount of bits
+    W_UINT32_HEX,       // ulong2str base 16
+    W_UINT32_OCT,       // ulong2str base 8
+    W_UINT32_BIN,       // ulong2str base 2
+    W_UINT32_B3,        // ulong2str base 3 (generic path)
+    W_UINT32_B12,       // ulong2str base 12 (generic path)
+    W_FIX2,             // fix2str, 2 decimals, 16 bits values
+    W_Q16_16,           // q16_16_2str, 4 decimals
+    W_COUNT
+};
+
+static const char *names[W_COUNT] = {
+    "ushort2str  dec all", "uint2str    dec all", "int2str     dec all",
+    "uint2str    dec 0-1023", "ulong2str   dec uniform", "ulong2str   dec bits",
+    "ulong2str   hex", "ulong2str   oct", "ulong2str   bin",
+    "ulong2str   base 3", "ulong2str   base 12", "fix2str     2 dec",
+    "q16_16_2str 4 dec"
+};
+
+typedef struct{
+    unsigned long calls;
+    unsigned long long sum[4];
+    uint32_t max[4];
+} result_t;
+
+static result_t results[W_COUNT];
+
+/**
+ * Run one conversion of workload w on x and record its counters
+ **/
+static void run( uint8_t w, uint32_t x ){
+    char buf[40];
+    result_t *r = &results[w];
+    uint32_t c[4];
+    uint8_t i;
+
+    memset( &num2str_stats, 0, sizeof num2str_stats );
+    switch( w ){
+        case W_UINT8_DEC:       ushort2str( (uint8_t)x, 10u, buf ); break;
+        case W_UINT16_DEC:
+        case W_UINT16_ADC:      uint2str( (uint16_t)x, 10u, buf ); break;
+        case W_INT16_DEC:       int2str( (int16_t)x, 10u, buf ); break;
+        case W_UINT32_DEC:
+        case W_UINT32_DEC_BITS: ulong2str( x, 10u, buf ); break;
+        case W_UINT32_HEX:      ulong2str( x, 16u, buf ); break;
+        case W_UINT32_OCT:      ulong2str( x, 8u, buf ); break;
+        case W_UINT32_BIN:      ulong2str( x, 2u, buf ); break;
+        case W_UINT32_B3:       ulong2str( x, 3u, buf ); break;
+        case W_UINT32_B12:      ulong2str( x, 12u, buf ); break;
+        case W_FIX2:            fix2str( (int16_t)x, 2u, buf ); break;
+        case W_Q16_16:          q16_16_2str( (int32_t)x, 4u, buf ); break;
+        default: break;
+    }
+    c[0] = num2str_stats.subtract;
+    c[1] = num2str_stats.divide;
+    c[2] = num2str_stats.shift;
+    c[3] = num2str_stats.put;
+    r->calls++;
+    for( i = 0; i < 4u; i++ ){
+        r->sum[i] += c[i];
+        if( c[i] > r->max[i] )
+            r->max[i] = c[i];
+    }
+}
+
+int main( void ){
+    uint32_t x;
+    uint8_t w, i;
+    long n;
+
+    for( x = 0; x < 256u; x++ )
+        run( W_UINT8_DEC, x );
+    for( x = 0; x < 65536u; x++ ){
+        run( W_UINT16_DEC, x );
+        run( W_INT16_DEC, x );
+        run( W_FIX2, x );
+    }
+    for( x = 0; x < 1024u; x++ )
+        run( W_UINT16_ADC, x );
+    for( n = 0; n < 200000; n++ ){
+        run( W_UINT32_DEC, rnd() );
+        run( W_UINT32_DEC_BITS, rnd_bits() );
+        run( W_UINT32_HEX, rnd() );
+        run( W_UINT32_OCT, rnd() );
+        run( W_UINT32_BIN, rnd() );
+        run( W_UINT32_B3, rnd() );
+        run( W_UINT32_B12, rnd() );
+        run( W_Q16_16, rnd() );
+    }
+
+    printf( "num2str operation counts per conversion (NUM2STR_DEC_PAIRS=%d)\n",
+            NUM2STR_DEC_PAIRS );
+    printf( "%-24s %8s %13s %13s %13s %13s\n", "workload", "calls",
+            "sub avg/max", "div avg/max", "shf avg/max", "put avg/max" );
+    for( w = 0; w < W_COUNT; w++ ){
+        result_t *r = &results[w];
+
+        printf( "%-24s %8lu", names[w], r->calls );
+        for( i = 0; i < 4u; i++ )
+            printf( " %8.2f/%-4lu", (double)r->sum[i] / r->calls, (unsigned long)r->max[i] );
+        printf( "\n" );
+    }
+    return 0;
+}
@@ -0,0 +1,479 @@
+/*
+ * File:   num2str_test.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Host (PC) checks of util/num2str against the C library (printf, strtol
+ * and strtod) and a plain division reference for the bases without printf
+ * format:
+ *  - every int8/uint8/int16/uint16 value on every base from 2 to 16
+ *  - random 32 bits values on every base, ulong2hex/oct/bin
+ *  - field routines (*2str_w) and sinks (*2sink)
+ *  - fix2str, q8_8_2str (every value), q16_16_2str and float2str
+ *  - str2uint, str2int, str2ulong, hex2uint and STR2NUM_Put
+ *  Exit status 0 when every check passes (see test/Makefile).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "num2str.h"
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+static unsigned long checks;
+static unsigned long fails;
+
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+/**
+ * Reproducible random numbers (xorshift32)
+ **/
+static uint32_t rnd_state = 0x12345678u;
+
+static uint32_t rnd( void ){
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+/**
+ * Random 32 bits value with a random amount of significant bits, so every
+ * length of number is checked (uniform values are mostly 10 digits long)
+ **/
+static uint32_t rnd_bits( void ){
+    uint8_t bits = (uint8_t)(rnd() % 33u);
+
+    return bits ? rnd() >> (32u - bits) : 0u;
+}
+
+/**
+ * Record a check, print the first failures
+ **/
+static void check( int ok, const char *what, const char *got, const char *exp ){
+    checks++;
+    if( ok )
+        return;
+    if( fails++ < 20u )
+        printf( "FAIL %s: got '%s' expected '%s'\n", what, got, exp );
+}
+
+/**
+ * Compare the n characters written by a routine with the expected string
+ **/
+static void check_str( const char *what, const char *buf, uint8_t n, const char *exp ){
+    char got[80];
+
+    memcpy( got, buf, n );
+    got[n] = '\0';
+    check( n == strlen( exp ) && strcmp( got, exp ) == 0, what, got, exp );
+}
+
+/**
+ * Reference: magnitude m on base b (upper case digits), with a '-' if neg
+ **/
+static void ref_radix( uint32_t m, int neg, unsigned b, char *out ){
+    char t[40];
+    int n = 0, k = 0;
+
+    do{
+        t[n++] = "0123456789ABCDEF"[m % b];
+        m /= b;
+    }while( m );
+    if( neg )
+        out[k++] = '-';
+    while( n )
+        out[k++] = t[--n];
+    out[k] = '\0';
+}
+
+/**
+ * Reference of a signed value on base b: printf on bases 8, 10 and 16, the
+ * division reference on the others. Every result is also read back with
+ * strtol/strtoul.
+ **/
+static void ref_signed( int32_t x, unsigned b, char *out ){
+    uint32_t m = x < 0 ? 0u - (uint32_t)x : (uint32_t)x;
+
+    if( b == 10u )
+        sprintf( out, "%ld", (long)x );
+    else if( b == 16u )
+        sprintf( out, "%s%lX", x < 0 ? "-" : "", (unsigned long)m );
+    else if( b == 8u )
+        sprintf( out, "%s%lo", x < 0 ? "-" : "", (unsigned long)m );
+    else
+        ref_radix( m, x < 0, b, out );
+    if( strtoll( out, NULL, (int)b ) != x ){
+        fails++;
+        printf( "FAIL reference %s base %u\n", out, b );
+    }
+}
+
+static void ref_unsigned( uint32_t x, unsigned b, char *out ){
+    if( b == 10u )
+        sprintf( out, "%lu", (unsigned long)x );
+    else if( b == 16u )
+        sprintf( out, "%lX", (unsigned long)x );
+    else if( b == 8u )
+        sprintf( out, "%lo", (unsigned long)x );
+    else
+        ref_radix( x, 0, b, out );
+    if( strtoull( out, NULL, (int)b ) != x ){
+        fails++;
+        printf( "FAIL reference %s base %u\n", out, b );
+    }
+}
+
+/**
+ * Reference of a field (see num2str.h): 'natural' is the number with its sign
+ **/
+static void ref_field( const char *natural, uint8_t width, char pad, char *out ){
+    int left = width & NUM2STR_ALIGN_LEFT;
+    int w = width & (uint8_t)~NUM2STR_ALIGN_LEFT;
+    int size = (int)strlen( natural );
+    int neg = natural[0] == '-';
+
+    if( w == 0 || size == w ){
+        strcpy( out, natural );
+    }
+    else if( size > w ){
+        memset( out, NUM2STR_OVERFLOW_CHAR, (size_t)w );
+        out[w] = '\0';
+    }
+    else if( left ){
+        sprintf( out, "%-*s", w, natural );
+    }
+    else if( pad == '0' ){
+        sprintf( out, "%s%0*d%s", neg ? "-" : "", w - size, 0, natural + neg );
+        if( w - size == 0 )
+            strcpy( out, natural );
+    }
+    else{
+        memset( out, pad, (size_t)(w - size) );
+        strcpy( out + w - size, natural );
+    }
+}
+
+/**
+ * Reference of a decimal fixed point number: m * 10^-decimals (magnitude)
+ **/
+static void ref_fix( uint64_t m, int neg, unsigned decimals, char *out ){
+    uint64_t pw = 1u;
+    unsigned i;
+
+    for( i = 0; i < decimals; i++ )
+        pw *= 10u;
+    if( m == 0u )
+        neg = 0;
+    if( decimals )
+        sprintf( out, "%s%llu.%0*llu", neg ? "-" : "", (unsigned long long)(m / pw),
+                 (int)decimals, (unsigned long long)(m % pw) );
+    else
+        sprintf( out, "%s%llu", neg ? "-" : "", (unsigned long long)m );
+}
+
+/******************************************************************************
+ ***************************** Section: Checks ********************************
+ ******************************************************************************/
+
+/**
+ * Every 8 and 16 bits value on every base (function and dispatch macro)
+ **/
+static void test_small( void ){
+    char buf[40], exp[40];
+    unsigned b;
+    long x;
+
+    for( b = 2u; b <= 16u; b++ ){
+        for( x = 0; x < 256; x++ ){
+            ref_unsigned( (uint32_t)x, b, exp );
+            check_str( "ushort2str", buf, (ushort2str)( (uint8_t)x, (uint8_t)b, buf ), exp );
+            check_str( "ushort2str macro", buf, ushort2str( (uint8_t)x, (uint8_t)b, buf ), exp );
+        }
+        for( x = -128; x < 128; x++ ){
+            ref_signed( (int32_t)x, b, exp );
+            check_str( "short2str", buf, short2str( (int8_t)x, (uint8_t)b, buf ), exp );
+        }
+        for( x = 0; x < 65536; x++ ){
+            ref_unsigned( (uint32_t)x, b, exp );
+            check_str( "uint2str", buf, (uint2str)( (uint16_t)x, (uint8_t)b, buf ), exp );
+            check_str( "uint2str macro", buf, uint2str( (uint16_t)x, (uint8_t)b, buf ), exp );
+        }
+        for( x = -32768; x < 32768; x++ ){
+            ref_signed( (int32_t)x, b, exp );
+            check_str( "int2str", buf, int2str( (int16_t)x, (uint8_t)b, buf ), exp );
+        }
+    }
+}
+
+/**
+ * Random 32 bits values on every base, and the power of two routines
+ **/
+static void test_long( void ){
+    char buf[40], exp[40];
+    unsigned b;
+    long i;
+
+    for( b = 2u; b <= 16u; b++ ){
+        for( i = 0; i < 40000; i++ ){
+            uint32_t x = (i & 1) ? rnd() : rnd_bits();
+
+            if( i < 4 )             // limits
+                x = (i == 0) ? 0u : (i == 1) ? 0xFFFFFFFFu : (i == 2) ? 0x80000000u : 0x7FFFFFFFu;
+            ref_unsigned( x, b, exp );
+            check_str( "ulong2str", buf, (ulong2str)( x, (uint8_t)b, buf ), exp );
+            check_str( "ulong2str macro", buf, ulong2str( x, (uint8_t)b, buf ), exp );
+            ref_signed( (int32_t)x, b, exp );
+            check_str( "long2str", buf, long2str( (int32_t)x, (uint8_t)b, buf ), exp );
+        }
+    }
+    for( i = 0; i < 200000; i++ ){
+        uint32_t x = (i & 1) ? rnd() : rnd_bits();
+
+        ref_unsigned( x, 16u, exp );
+        check_str( "ulong2hex", buf, ulong2hex( x, buf ), exp );
+        ref_unsigned( x, 8u, exp );
+        check_str( "ulong2oct", buf, ulong2oct( x, buf ), exp );
+        ref_unsigned( x, 2u, exp );
+        check_str( "ulong2bin", buf, ulong2bin( x, buf ), exp );
+    }
+}
+
+/**
+ * Field routines and sinks (the sinks must give the same characters)
+ **/
+static void test_field( void ){
+    char buf[160], exp[160], nat[40], snk[160], *cursor;
+    const num2str_sink_t sink = { NUM2STR_BufferPut, &cursor };
+    static const char pads[] = { ' ', '0', '*' };
+    long i;
+
+    for( i = 0; i < 300000; i++ ){
+        uint32_t x = rnd_bits();
+        uint8_t b = (uint8_t)(2u + rnd() % 15u);
+        uint8_t width = (uint8_t)(rnd() % 14u);
+        char pad = pads[rnd() % 3u];
+        uint8_t n;
+
+        if( rnd() & 1u )
+            width |= NUM2STR_ALIGN_LEFT;
+
+        ref_unsigned( x, b, nat );
+        ref_field( nat, width, pad, exp );
+        check_str( "ulong2str_w", buf, ulong2str_w( x, b, width, pad, buf ), exp );
+        cursor = snk;
+        n = ulong2sink( x, b, width, pad, &sink );
+        check_str( "ulong2sink", snk, (uint8_t)(cursor - snk), exp );
+        check( n == (uint8_t)(cursor - snk), "ulong2sink count", "", "" );
+        if( x <= 0xFFFFu ){
+            check_str( "uint2str_w", buf, uint2str_w( (uint16_t)x, b, width, pad, buf ), exp );
+            if( x <= 0xFFu )
+                check_str( "ushort2str_w", buf, ushort2str_w( (uint8_t)x, b, width, pad, buf ), exp );
+        }
+
+        ref_signed( (int32_t)x, b, nat );
+        ref_field( nat, width, pad, exp );
+        check_str( "long2str_w", buf, long2str_w( (int32_t)x, b, width, pad, buf ), exp );
+        cursor = snk;
+        long2sink( (int32_t)x, b, width, pad, &sink );
+        check_str( "long2sink", snk, (uint8_t)(cursor - snk), exp );
+
+        ref_signed( (int16_t)x, b, nat );
+        ref_field( nat, width, pad, exp );
+        check_str( "int2str_w", buf, int2str_w( (int16_t)x, b, width, pad, buf ), exp );
+        ref_signed( (int8_t)x, b, nat );
+        ref_field( nat, width, pad, exp );
+        check_str( "short2str_w", buf, short2str_w( (int8_t)x, b, width, pad, buf ), exp );
+    }
+
+    // printf gives the same result while the number fits
+    for( i = -100000; i <= 100000; i += 7 ){
+        sprintf( exp, "%8ld", i );
+        check_str( "long2str_w %8ld", buf, long2str_w( (int32_t)i, 10u, 8u, ' ', buf ), exp );
+        sprintf( exp, "%08ld", i );
+        check_str( "long2str_w %08ld", buf, long2str_w( (int32_t)i, 10u, 8u, '0', buf ), exp );
+        sprintf( exp, "%-8ld", i );
+        check_str( "long2str_w %-8ld", buf, long2str_w( (int32_t)i, 10u, 8u | NUM2STR_ALIGN_LEFT, ' ', buf ), exp );
+    }
+}
+
+/**
+ * Fixed point and float routines
+ **/
+static void test_fixed( void ){
+    char buf[80], exp[80], snk[80], *cursor;
+    const num2str_sink_t sink = { NUM2STR_BufferPut, &cursor };
+    long i;
+    unsigned d;
+
+    // fix2str / fix2sink: random values, every amount of decimals
+    for( i = 0; i < 300000; i++ ){
+        int32_t x = (int32_t)((i & 1) ? rnd() : rnd_bits());
+        uint64_t m = x < 0 ? 0u - (uint64_t)(int64_t)x : (uint64_t)x;
+
+        d = (unsigned)(rnd() % 10u);
+        ref_fix( m, x < 0, d, exp );
+        check_str( "fix2str", buf, fix2str( x, (uint8_t)d, buf ), exp );
+        cursor = snk;
+        fix2sink( x, (uint8_t)d, 0u, ' ', &sink );
+        check_str( "fix2sink", snk, (uint8_t)(cursor - snk), exp );
+    }
+
+    // q8_8_2str: every value, rounded to nearest (ties away from zero)
+    for( i = -32768; i < 32768; i++ ){
+        uint64_t m = (uint64_t)(i < 0 ? -i : i);
+
+        for( d = 0u; d <= NUM2STR_FIX_MAX_DECIMALS; d++ ){
+            uint64_t pw = 1u;
+            unsigned k;
+
+            for( k = 0; k < d; k++ )
+                pw *= 10u;
+            ref_fix( (m * pw + 128u) >> 8, i < 0, d, exp );
+            check_str( "q8_8_2str", buf, q8_8_2str( (int16_t)i, (uint8_t)d, buf ), exp );
+            // the rounded value is at 0.5 * 10^-d of the exact one
+            buf[q8_8_2str( (int16_t)i, (uint8_t)d, buf )] = '\0';
+            check( fabs( strtod( buf, NULL ) - i / 256.0 ) <= 0.5 / pw + 1e-9,
+                   "q8_8_2str error", buf, "" );
+        }
+    }
+
+    // q16_16_2str: random values
+    for( i = 0; i < 300000; i++ ){
+        int32_t x = (int32_t)((i & 1) ? rnd() : rnd_bits());
+        uint64_t m = x < 0 ? 0u - (uint64_t)(int64_t)x : (uint64_t)x;
+        uint64_t pw = 1u;
+        unsigned k;
+
+        d = (unsigned)(rnd() % (NUM2STR_FIX_MAX_DECIMALS + 1u));
+        for( k = 0; k < d; k++ )
+            pw *= 10u;
+        ref_fix( (m * pw + 32768u) >> 16, x < 0, d, exp );
+        check_str( "q16_16_2str", buf, q16_16_2str( x, (uint8_t)d, buf ), exp );
+    }
+
+    // float2str: the printed value must be at half a unit of the last
+    // decimal (plus the float rounding) and keep the decimals that fit
+    for( i = 0; i < 300000; i++ ){
+        float x = (float)ldexp( (double)(int32_t)rnd(), (int)(rnd() % 40u) - 40 );
+        double pw, err;
+        const char *dot;
+        uint8_t n;
+
+        d = (unsigned)(rnd() % 10u);
+        n = float2str( x, (uint8_t)d, buf );
+        buf[n] = '\0';
+        dot = strchr( buf, '.' );
+        pw = pow( 10.0, dot ? (double)strlen( dot + 1 ) : 0.0 );
+        err = fabs( strtod( buf, NULL ) - x );
+        check( err <= 0.5 / pw + fabs( x ) * 1.2e-7, "float2str error", buf, "" );
+        if( fabs( x ) * pow( 10.0, d ) < 2.0e9 )
+            check( pw == pow( 10.0, d ), "float2str decimals", buf, "" );
+    }
+    check_str( "float2str 9", buf, float2str( 1.25f, 9u, buf ), "1.250000000" );
+    check_str( "float2str range", buf, float2str( 100000.0f, 5u, buf ), "100000.0000" );
+    check_str( "float2str 2^31", buf, float2str( 3e9f, 0u, buf ), "#" );
+    check_str( "float2str NaN", buf, float2str( NAN, 2u, buf ), "#" );
+}
+
+/**
+ * String to number routines against strtol/strtoul
+ **/
+static void test_parse( void ){
+    char s[64];
+    long v;
+    long i;
+
+    for( v = -40000; v <= 140000; v++ ){
+        uint16_t u;
+        int16_t x;
+        uint8_t n, len;
+
+        len = (uint8_t)sprintf( s, "%ld", v );
+        strcat( s, ";" );
+        n = str2uint( s, &u );
+        check( (v >= 0 && v <= 65535) ? (n == len && u == strtoul( s, NULL, 10 )) : n == 0u,
+               "str2uint", s, "" );
+        n = str2int( s, &x );
+        check( (v >= -32768 && v <= 32767) ? (n == len && x == strtol( s, NULL, 10 )) : n == 0u,
+               "str2int", s, "" );
+        len = (uint8_t)sprintf( s, (v & 1) ? "%lX" : "%lx", v & 0x1FFFFl );
+        n = hex2uint( s, &u );
+        check( ((v & 0x1FFFFl) <= 0xFFFFl) ? (n == len && u == strtoul( s, NULL, 16 )) : n == 0u,
+               "hex2uint", s, "" );
+    }
+    for( i = 0; i < 500000; i++ ){
+        unsigned long long x = ((unsigned long long)rnd() << 32 | rnd()) % 10000000000ull;
+        uint32_t l;
+        uint8_t n, len;
+
+        if( i & 1 )
+            x %= 5000000000ull;
+        len = (uint8_t)sprintf( s, "%llu", x );
+        n = str2ulong( s, &l );
+        check( (x <= 0xFFFFFFFFull) ? (n == len && l == strtoul( s, NULL, 10 )) : n == 0u,
+               "str2ulong", s, "" );
+    }
+    {
+        static const char *bad[] = { "", "-", "+", "x", "-x", "--1", "4294967296", "99999999999" };
+        uint32_t l;
+        unsigned k;
+
+        for( k = 0; k < sizeof bad / sizeof bad[0]; k++ )
+            check( str2ulong( bad[k], &l ) == 0u, "str2ulong error", bad[k], "" );
+    }
+    {
+        char z[300];
+        uint16_t u = 0u;
+        uint8_t n;
+
+        memset( z, '0', sizeof z );     // leading zeros: 253 + "12" fit
+        strcpy( z + 253, "12;" );
+        n = str2uint( z, &u );
+        check( n == 255u && u == 12u, "str2uint 255 chars", z + 250, "" );
+        memset( z, '0', sizeof z );     // 297 zeros + "12": too long
+        strcpy( z + 297, "12" );
+        check( str2uint( z, &u ) == 0u, "str2uint 299 chars", z + 290, "" );
+    }
+    {
+        static const struct{ const char *s; uint8_t n; long v; } hex[] = {
+            { "-7fff", 5u, -0x7FFFl }, { "+7FFF", 5u, 0x7FFFl }, { "-8000", 5u, -0x8000l },
+            { "8000", 0u, 0l }, { "-8001", 0u, 0l }, { "-", 0u, 0l }, { "-+1", 0u, 0l },
+            { "-1a;", 3u, -0x1Al }
+        };
+        str2num_t p;
+        unsigned k;
+
+        for( k = 0; k < sizeof hex / sizeof hex[0]; k++ ){
+            const char *c = hex[k].s;
+            long v;
+
+            STR2NUM_Initialize( &p, STR2NUM_HEX | STR2NUM_SIGNED, 0x7FFFu );
+            while( STR2NUM_Put( &p, *c ) == STR2NUM_BUSY )
+                c++;
+            v = (p.flags & STR2NUM_NEG) ? -(long)p.value : (long)p.value;
+            check( hex[k].n ? (p.state == STR2NUM_DONE && p.count == hex[k].n && v == hex[k].v)
+                            : p.state == STR2NUM_ERROR,
+                   "STR2NUM signed hex", hex[k].s, "" );
+        }
+    }
+}
+
+int main( void ){
+    test_small();
+    test_long();
+    test_field();
+    test_fixed();
+    test_parse();
+
+    printf( "num2str (NUM2STR_DEC_PAIRS=%d): %lu checks, %lu failures\n",
+            NUM2STR_DEC_PAIRS, checks, fails );
+    return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
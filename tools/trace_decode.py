@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Decoder for the dumps of util/trace.c (TRACE_Dump).
+
+Prints one line per event with the time since the first event: the 16 bits
+Timer1 time stamps are unwrapped assuming less than 65536 counts between two
+consecutive events.
+
+Usage:
+    trace_decode.py dump.txt                  # TRACE_DUMP_TEXT (serial log)
+    trace_decode.py --binary eeprom.bin       # TRACE_DUMP_BINARY
+    trace_decode.py --clock 5000000 dump.txt  # Timer1 counts/s -> microseconds
+"""
+
+import argparse
+import sys
+
+EVENTS = {
+    0x01: "ISR",
+    0x02: "SPI_BYTE",
+    0x03: "ADC_DONE",
+    0x04: "DISPLAY",
+}
+
+ISR_SOURCES = ["TMR0", "TMR1", "SSP", "AD", "EE", "RC"]
+
+
+def parse_text(data):
+    lines = data.decode("ascii", "replace").splitlines()
+    records = []
+    start = None
+    for i, line in enumerate(lines):
+        if line.startswith("TRACE "):
+            start = i
+    if start is None:
+        sys.exit("no 'TRACE <n>' header found")
+    count = int(lines[start].split()[1])
+    for line in lines[start + 1:start + 1 + count]:
+        ev, payload, time = (int(f, 16) for f in line.split())
+        records.append((ev, payload, time))
+    return records
+
+
+def parse_binary(data):
+    count = data[0]
+    body = data[1:1 + 4 * count]
+    if len(body) < 4 * count:
+        sys.exit("truncated dump: %d records expected" % count)
+    return [(body[i], body[i + 1], body[i + 2] | (body[i + 3] << 8))
+            for i in range(0, len(body), 4)]
+
+
+def describe(ev, payload):
+    name = EVENTS.get(ev, "USER+%d" % (ev - 0x10) if ev >= 0x10 else "0x%02X" % ev)
+    if ev == 0x01 and payload < len(ISR_SOURCES):
+        return name, ISR_SOURCES[payload]
+    return name, "0x%02X" % payload
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump")
+    parser.add_argument("--binary", action="store_true",
+                        help="dump made with TRACE_DUMP_BINARY")
+    parser.add_argument("--clock", type=float, default=0,
+                        help="Timer1 counts per second (print microseconds)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+    records = parse_binary(data) if args.binary else parse_text(data)
+
+    elapsed = 0
+    previous = None
+    for ev, payload, time in records:
+        if previous is not None:
+            elapsed += (time - previous) & 0xFFFF
+        previous = time
+        name, value = describe(ev, payload)
+        if args.clock:
+            stamp = "%12.1fus" % (elapsed * 1e6 / args.clock)
+        else:
+            stamp = "%10d" % elapsed
+        print("%s  %-10s %s" % (stamp, name, value))
+
+
+if __name__ == "__main__":
+    main()
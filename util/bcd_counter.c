@@ -0,0 +1,122 @@
+/*
+ * File:   bcd_counter.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the ASCII/BCD counter (see bcd_counter.h).
+ *  The digits are updated from the right side and the loops stop as soon as
+ * there is no carry (or borrow), so the common case (one digit) takes only
+ * a few instructions.
+ */
+
+#include <stdint.h>
+#include "bcd_counter.h"
+#include "num2str.h"
+
+void BCD_Initialize( bcd_counter_t *c, char *digits, uint8_t len ){
+    c->digits = digits;
+    c->len = len;
+    while( len ){
+        digits[--len] = '0';
+    }
+}
+
+uint8_t BCD_Set( bcd_counter_t *c, uint32_t value ){
+    uint8_t i;
+
+    ulong2str_w( value, 10u, c->len, '0', c->digits );
+    if( c->digits[0] == NUM2STR_OVERFLOW_CHAR ){    // value >= 10^len
+        for( i = 0u; i < c->len; i++ )
+            c->digits[i] = '9';
+    }
+    return 0u;
+}
+
+uint8_t BCD_Increment( bcd_counter_t *c ){
+    uint8_t i = c->len;
+
+    while( i ){
+        i--;
+        if( c->digits[i] != '9' ){  // no carry
+            c->digits[i]++;
+            return i;
+        }
+        c->digits[i] = '0';
+    }
+    return 0u;                      // wrap around
+}
+
+uint8_t BCD_Decrement( bcd_counter_t *c ){
+    uint8_t i = c->len;
+
+    while( i ){
+        i--;
+        if( c->digits[i] != '0' ){  // no borrow
+            c->digits[i]--;
+            return i;
+        }
+        c->digits[i] = '9';
+    }
+    return 0u;                      // wrap around
+}
+
+uint8_t BCD_Add( bcd_counter_t *c, uint8_t delta ){
+    uint8_t i = c->len;
+    uint8_t first = c->len;
+
+    // 'delta' is the amount still to add on the digit i
+    while( delta && i ){
+        uint8_t q = 0u;
+        uint8_t d;
+        char digit;
+
+        i--;
+        while( delta >= 10u ){          // split: delta = 10*q + units
+            delta -= 10u;
+            q++;
+        }
+        d = delta + (uint8_t)(c->digits[i] - '0');
+        if( d >= 10u ){                 // carry
+            d -= 10u;
+            q++;
+        }
+        digit = (char)d + '0';
+        if( c->digits[i] != digit ){
+            c->digits[i] = digit;
+            first = i;
+        }
+        delta = q;
+    }
+    return first;
+}
+
+uint8_t BCD_Sub( bcd_counter_t *c, uint8_t delta ){
+    uint8_t i = c->len;
+    uint8_t first = c->len;
+
+    // 'delta' is the amount still to subtract from the digit i
+    while( delta && i ){
+        uint8_t q = 0u;
+        uint8_t d;
+        char digit;
+
+        i--;
+        while( delta >= 10u ){          // split: delta = 10*q + units
+            delta -= 10u;
+            q++;
+        }
+        d = (uint8_t)(c->digits[i] - '0');
+        if( d < delta ){                // borrow
+            d += 10u;
+            q++;
+        }
+        d -= delta;
+        digit = (char)d + '0';
+        if( c->digits[i] != digit ){
+            c->digits[i] = digit;
+            first = i;
+        }
+        delta = q;
+    }
+    return first;
+}
@@ -0,0 +1,99 @@
+/*
+ * File:   bcd_counter.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Decimal counter stored as ASCII digits (unpacked BCD), most significant
+ * digit first. The digits can live directly inside a display buffer (Ej: the
+ * HCMS-29xx buffer or a string printed on the LCD), so the counter never
+ * need be converted with uint2str.
+ *  Increment, decrement and add/sub of a small delta only touch the digits
+ * that change and return the position of the leftmost changed digit. All the
+ * positions from that one to the last digit may have changed, the positions
+ * on the left are the same.
+ *  The counter wraps around: 99..9 + 1 = 00..0 and 00..0 - 1 = 99..9.
+ *
+ * @Example
+ * <code>
+ *  char text[] = "T=0000";
+ *  bcd_counter_t cnt;
+ *  uint8_t first;
+ *
+ *  BCD_Initialize( &cnt, text+2, 4 );
+ *  LCD_SetCursorPosition( 1, 1 );
+ *  LCD_PrintString( text );
+ *  while( 1 ){
+ *      first = BCD_Increment( &cnt );
+ *      // rewrite only the changed characters
+ *      LCD_SetCursorPosition( 1, 1 + 2 + first );
+ *      LCD_PrintString( text + 2 + first );
+ *  }
+ * </code>
+ *  The HCMS-29xx dot register can not be partially loaded, but if the digits
+ * are inside the display buffer only LedDisplay_LoadDotRegister() is needed
+ * (and it can be skipped when BCD_Changed() is false).
+ */
+
+#ifndef BCD_COUNTER_H
+#define	BCD_COUNTER_H
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Counter object
+ **/
+typedef struct{
+    char *digits;       // ASCII digits, most significant first
+    uint8_t len;        // amount of digits
+} bcd_counter_t;
+
+/**
+ * True if the value returned by an update routine report changed digits
+ **/
+#define BCD_Changed( c, first )     ( (first) < (c)->len )
+
+    /**
+     * Attach the counter to 'len' characters starting on 'digits' and set it
+     * to zero ("00..0").
+     **/
+    void BCD_Initialize( bcd_counter_t *c, char *digits, uint8_t len );
+
+    /**
+     * Set the counter value. A value >= 10^len is clamped to 99..9, so the
+     * digits are always valid. Every digit is rewritten, so the return value
+     * is always 0.
+     **/
+    uint8_t BCD_Set( bcd_counter_t *c, uint32_t value );
+
+    /**
+     * Add one to the counter. Return the position of the leftmost changed digit.
+     **/
+    uint8_t BCD_Increment( bcd_counter_t *c );
+
+    /**
+     * Subtract one from the counter. Return the position of the leftmost
+     * changed digit.
+     **/
+    uint8_t BCD_Decrement( bcd_counter_t *c );
+
+    /**
+     * Add delta to the counter. Return the position of the leftmost changed
+     * digit, or len if no digit changed (delta = 0).
+     **/
+    uint8_t BCD_Add( bcd_counter_t *c, uint8_t delta );
+
+    /**
+     * Subtract delta from the counter. Return the position of the leftmost
+     * changed digit, or len if no digit changed (delta = 0).
+     **/
+    uint8_t BCD_Sub( bcd_counter_t *c, uint8_t delta );
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* BCD_COUNTER_H */
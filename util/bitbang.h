@@ -0,0 +1,97 @@
+/*
+ * File:   bitbang.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Bit-banged synchronous serial output (data + clock pins) for the drivers
+ * of devices without SPI hardware or on MCUs without MSSP (Ej: PIC12F683).
+ * The 8 bits of a byte are fully unrolled: the bit masks are constants, so
+ * every bit compiles to a bit test of the byte that selects a set or a
+ * clear of the data pin and the clock pulse (BTFSC/BSF, BTFSS/BCF, BSF,
+ * BCF with XC8), without shifts or loop counter. The data pin is written
+ * once per bit, so it does not glitch when two bits are equal.
+ *  The data pin changes while the clock is low and it is sampled on the
+ * rising edge of the clock (595, HCMS-29xx and most SPI mode 0 devices).
+ * The clock pin must be low before the first bit and it is low after the
+ * last one.
+ *  'data' and 'clk' are the bit variables of the pins (Ej: GP0, RB2 or
+ * PORTBbits.RB2). 'highDelay' is a statement executed after the rising edge
+ * of the clock and 'lowDelay' after the falling edge, to slow down the bit
+ * rate (Ej: __delay_us(1)), both can be empty.
+ *
+ *  BITBANG_SEND_MSB_FIRST( data, clk, highDelay, lowDelay, byte ) /
+ * BITBANG_SEND_LSB_FIRST are statements for use inside a driver routine
+ * (see 595_ShiftRegister_lite.c). Every use is 8 copies of the bit.
+ *  BITBANG_DEFINE( name, order, data, clk, highDelay, lowDelay ) creates the
+ * routine 'static void name( uint8_t byte )' of a pin set, 'order' is
+ * MSB_FIRST or LSB_FIRST (see HCMS-29xx_lite.c). Define one routine per pin
+ * set and order, and call it.
+ *  test/bitbang_bench.c counts the operations per byte against the rolled
+ * loops.
+ *
+ * @Example
+ * <code>
+ *  BITBANG_DEFINE( dac_SendByte, MSB_FIRST, GP0, GP1, , )
+ *  ...
+ *  GP2 = 0;                    // chip select
+ *  dac_SendByte( cmd >> 8 );
+ *  dac_SendByte( (uint8_t)cmd );
+ *  GP2 = 1;
+ * </code>
+ */
+
+#ifndef BITBANG_H
+#define	BITBANG_H
+
+#include <stdint.h>
+
+/**
+ * Send the bit 'mask' of byte: data pin and one clock pulse
+ **/
+#define BITBANG_BIT( data, clk, highDelay, lowDelay, byte, mask )           \
+        if( (byte) & (mask) )                                               \
+            data = 1;                                                       \
+        else                                                                \
+            data = 0;                                                       \
+        clk = 1;                                                            \
+        highDelay;                                                          \
+        clk = 0;                                                            \
+        lowDelay;
+
+/**
+ * Send a byte, first the most significant bit
+ **/
+#define BITBANG_SEND_MSB_FIRST( data, clk, highDelay, lowDelay, byte ) do{  \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x80u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x40u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x20u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x10u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x08u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x04u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x02u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x01u )          \
+    }while(0)
+
+/**
+ * Send a byte, first the least significant bit
+ **/
+#define BITBANG_SEND_LSB_FIRST( data, clk, highDelay, lowDelay, byte ) do{  \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x01u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x02u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x04u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x08u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x10u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x20u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x40u )          \
+        BITBANG_BIT( data, clk, highDelay, lowDelay, byte, 0x80u )          \
+    }while(0)
+
+/**
+ * Define the send routine 'name' of a pin set (order: MSB_FIRST or LSB_FIRST)
+ **/
+#define BITBANG_DEFINE( name, order, data, clk, highDelay, lowDelay )       \
+        static void name( uint8_t byte ){                                   \
+            BITBANG_SEND_##order( data, clk, highDelay, lowDelay, byte );   \
+        }
+
+#endif	/* BITBANG_H */
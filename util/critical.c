@@ -0,0 +1,48 @@
+/*
+ * File:   critical.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Instrumentation of the critical sections (see critical.h).
+ */
+
+#include <stdint.h>
+#include "critical.h"
+#include "profile.h"
+
+#if CRITICAL_STATS
+
+/******************************************************************************
+ ************************** Section: Global Vars ******************************
+ ******************************************************************************/
+
+uint16_t critical_maxCycles;
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+static uint16_t critical_start;
+
+/******************************************************************************
+ ************************ Section: Critical APIs *******************************
+ ******************************************************************************/
+
+void CRITICAL_StatsStart( void ){
+    critical_start = PROFILE_Now();
+}
+
+void CRITICAL_StatsStop( void ){
+    uint16_t window = PROFILE_Now() - critical_start;
+
+    if( window > critical_maxCycles )
+        critical_maxCycles = window;
+}
+
+void CRITICAL_StatsClear( void ){
+    CRITICAL_ENTER();
+    critical_maxCycles = 0u;
+    CRITICAL_EXIT();
+}
+
+#endif
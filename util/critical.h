@@ -0,0 +1,99 @@
+/*
+ * File:   critical.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Critical sections: code executed with the global interrupts disabled.
+ * CRITICAL_ENTER saves GIE and clears it, CRITICAL_EXIT sets GIE again only
+ * if it was set on the enter, so:
+ *  - A routine can use a critical section when the caller has the
+ *    interrupts disabled (they are not enabled on the exit).
+ *  - Critical sections can be nested, only the outer one enables GIE.
+ *  The pair opens and closes a block ({ }), they must be used on the same
+ * function and level, and the code between them can not return or break
+ * out of the section. Keep the sections short: they delay every interrupt.
+ *  Without CRITICAL_STATS the enter is 4 instructions and the exit 2.
+ *
+ *  The global interrupt enable bit (CRITICAL_GIE) is given by the header of
+ * the device: peripheral/<device>/critical_<device>.h. On other targets (Ej:
+ * a host build) define CRITICAL_GIE before include this file.
+ *
+ * @Example
+ * <code>
+ *  CRITICAL_ENTER();
+ *  copy = sharedCounter;       // 32 bits variable written by the ISR
+ *  CRITICAL_EXIT();
+ * </code>
+ */
+
+#ifndef CRITICAL_H
+#define	CRITICAL_H
+
+#include <stdint.h>
+
+#ifndef CRITICAL_GIE
+#if defined(_16F887)
+#include "../peripheral/16F887/critical_16f887.h"
+#elif defined(_12F683)
+#include "../peripheral/12f683/critical_12f683.h"
+#else
+#error "critical.h: device not supported, define CRITICAL_GIE"
+#endif
+#endif
+
+/**
+ * Instrumentation: measure the longest window with the interrupts disabled
+ * by the critical sections (only the outer section of a nest is measured).
+ *  The time is read from Timer1 (PROFILE_Now), it must be running with
+ * Fosc/4 and 1:1 prescaler to get instruction cycles (Ej: started by
+ * PROFILE_Initialize, or T1CON = 0x01). The windows of the interrupt
+ * routine are not included (see ISR_STATS).
+ **/
+#ifndef CRITICAL_STATS
+#define CRITICAL_STATS  0
+#endif
+
+#if CRITICAL_STATS
+
+extern uint16_t critical_maxCycles;     // longest window (Timer1 counts)
+
+#define CRITICAL_ENTER()    { uint8_t critical_gie = CRITICAL_GIE;          \
+                              CRITICAL_GIE = 0;                             \
+                              if( critical_gie ) CRITICAL_StatsStart();
+
+#define CRITICAL_EXIT()       if( critical_gie ){                           \
+                                  CRITICAL_StatsStop();                     \
+                                  CRITICAL_GIE = 1;                         \
+                              } }
+
+#else
+
+#define CRITICAL_ENTER()    { uint8_t critical_gie = CRITICAL_GIE;          \
+                              CRITICAL_GIE = 0;
+
+#define CRITICAL_EXIT()       if( critical_gie ) CRITICAL_GIE = 1; }
+
+#endif
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#if CRITICAL_STATS
+    /**
+     * Start / stop the measure of a window (used by the macros)
+     **/
+    void CRITICAL_StatsStart( void );
+    void CRITICAL_StatsStop( void );
+
+    /**
+     * Clear critical_maxCycles
+     **/
+    void CRITICAL_StatsClear( void );
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* CRITICAL_H */
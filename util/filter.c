@@ -0,0 +1,125 @@
+/*
+ * File:   filter.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the ADC sample filters (see filter.h).
+ */
+
+#include <stdint.h>
+#include "filter.h"
+
+#if FILTER_MEDIAN_SIZE != 3u && FILTER_MEDIAN_SIZE != 5u
+#error "FILTER_MEDIAN_SIZE must be 3 or 5"
+#endif
+
+/**
+ * Compare-exchange step of the sorting networks: a <= b after it
+ **/
+#define filter_Sort( a, b )     do{                 \
+            if( (a) > (b) ){                        \
+                uint16_t filter_t = (a);            \
+                (a) = (b);                          \
+                (b) = filter_t;                     \
+            }                                       \
+        }while(0)
+
+/******************************************************************************
+ ************************ Section: Moving Average *****************************
+ ******************************************************************************/
+
+void FILTER_AvgInitialize( filter_avg_t *f, uint16_t *buffer, uint8_t shift, uint16_t initial ){
+    uint8_t i;
+
+    f->buffer = buffer;
+    f->shift = shift;
+    f->mask = (uint8_t)((1u << shift) - 1u);
+    f->index = 0u;
+    f->sum = 0u;
+    for( i = 0u; i <= f->mask; i++ ){
+        buffer[i] = initial;
+        f->sum += initial;
+    }
+}
+
+uint16_t FILTER_AvgPut( filter_avg_t *f, uint16_t x ){
+    // running sum: replace the oldest sample
+    f->sum += x - f->buffer[f->index];
+    f->buffer[f->index] = x;
+    f->index = (f->index + 1u) & f->mask;
+    return f->sum >> f->shift;
+}
+
+/******************************************************************************
+ ****************************** Section: IIR **********************************
+ ******************************************************************************/
+
+void FILTER_IirInitialize( filter_iir_t *f, uint8_t shift, uint16_t initial ){
+    f->shift = shift;
+    f->acc = initial << shift;
+}
+
+uint16_t FILTER_IirPut( filter_iir_t *f, uint16_t x ){
+    // acc = y * 2^k:  acc += x - y
+    f->acc += x - (f->acc >> f->shift);
+    return f->acc >> f->shift;
+}
+
+/******************************************************************************
+ ***************************** Section: Median ********************************
+ ******************************************************************************/
+
+uint16_t FILTER_Median3( uint16_t a, uint16_t b, uint16_t c ){
+    filter_Sort( a, b );
+    filter_Sort( b, c );
+    filter_Sort( a, b );
+    return b;
+}
+
+uint16_t FILTER_Median5( const uint16_t *p ){
+    uint16_t a = p[0], b = p[1], c = p[2], d = p[3], e = p[4];
+
+    filter_Sort( a, b );
+    filter_Sort( d, e );
+    filter_Sort( a, d );
+    filter_Sort( b, e );
+    filter_Sort( b, c );
+    filter_Sort( c, d );
+    filter_Sort( b, c );
+    return c;
+}
+
+void FILTER_MedianInitialize( filter_median_t *f, uint16_t initial ){
+    uint8_t i;
+
+    for( i = 0u; i < FILTER_MEDIAN_SIZE; i++ )
+        f->window[i] = initial;
+    f->index = 0u;
+}
+
+uint16_t FILTER_MedianPut( filter_median_t *f, uint16_t x ){
+    f->window[f->index] = x;
+    if( ++f->index == FILTER_MEDIAN_SIZE )
+        f->index = 0u;
+#if FILTER_MEDIAN_SIZE == 3u
+    return FILTER_Median3( f->window[0], f->window[1], f->window[2] );
+#else
+    return FILTER_Median5( f->window );
+#endif
+}
+
+/******************************************************************************
+ ***************************** Section: Min/Max *******************************
+ ******************************************************************************/
+
+void FILTER_MinMaxReset( filter_minmax_t *f ){
+    f->min = 0xFFFFu;
+    f->max = 0u;
+}
+
+void FILTER_MinMaxPut( filter_minmax_t *f, uint16_t x ){
+    if( x < f->min )
+        f->min = x;
+    if( x > f->max )
+        f->max = x;
+}
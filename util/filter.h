@@ -0,0 +1,134 @@
+/*
+ * File:   filter.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Digital filters for ADC samples: moving average, first order IIR
+ * (exponential smoothing), median of 3 or 5 samples and minimum/maximum
+ * tracker.
+ *  The samples are uint16_t, so adc_result_t of every device (8 or 10
+ * bits) can be used directly. Every Put routine has a constant cost (no
+ * loops over the window, no multiply or division) and works on its own
+ * filter object, so the filters can run inside the ADC ISR.
+ *  The sums are 16 bits: the filters are exact while the window (moving
+ * average) or the gain (IIR) multiplied by the maximum sample fits on 16
+ * bits. Ej: up to 64 samples of 10 bits.
+ *
+ * @Example
+ * <code>
+ *  static uint16_t avgBuffer[16];
+ *  static filter_avg_t avg;
+ *  static filter_median_t med;
+ *
+ *  FILTER_AvgInitialize( &avg, avgBuffer, 4u, 0u );    // 2^4 samples
+ *  FILTER_MedianInitialize( &med, 0u );
+ *  ...
+ *  // on every conversion: remove spikes, then average
+ *  value = FILTER_AvgPut( &avg, FILTER_MedianPut( &med, ADC_GetConversion( channel ) ) );
+ * </code>
+ */
+
+#ifndef FILTER_H
+#define	FILTER_H
+
+#include <stdint.h>
+
+/**
+ * Median window (3 or 5 samples)
+ **/
+#ifndef FILTER_MEDIAN_SIZE
+#define FILTER_MEDIAN_SIZE  5u
+#endif
+
+/**
+ * Moving average over 2^shift samples (the buffer is owned by the caller)
+ **/
+typedef struct{
+    uint16_t *buffer;           // 2^shift samples
+    uint16_t sum;               // sum of the samples on the buffer
+    uint8_t mask;               // 2^shift - 1
+    uint8_t shift;
+    uint8_t index;              // oldest sample
+} filter_avg_t;
+
+/**
+ * First order IIR: y += (x - y) / 2^shift
+ **/
+typedef struct{
+    uint16_t acc;               // y * 2^shift
+    uint8_t shift;
+} filter_iir_t;
+
+/**
+ * Median of the last FILTER_MEDIAN_SIZE samples
+ **/
+typedef struct{
+    uint16_t window[FILTER_MEDIAN_SIZE];
+    uint8_t index;              // oldest sample
+} filter_median_t;
+
+/**
+ * Minimum and maximum samples
+ **/
+typedef struct{
+    uint16_t min;
+    uint16_t max;
+} filter_minmax_t;
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    /**
+     * Initialize the moving average with a buffer of 2^shift samples
+     * (shift <= 7) filled with 'initial' (the first outputs are not pulled
+     * towards 0).
+     **/
+    void FILTER_AvgInitialize( filter_avg_t *f, uint16_t *buffer, uint8_t shift, uint16_t initial );
+
+    /**
+     * Add a sample, return the average of the last 2^shift samples
+     **/
+    uint16_t FILTER_AvgPut( filter_avg_t *f, uint16_t x );
+
+    /**
+     * Initialize the IIR with the output 'initial'. A bigger shift gives a
+     * slower response: the step response reaches 63% after about 2^shift
+     * samples.
+     **/
+    void FILTER_IirInitialize( filter_iir_t *f, uint8_t shift, uint16_t initial );
+
+    /**
+     * Add a sample, return the new output
+     **/
+    uint16_t FILTER_IirPut( filter_iir_t *f, uint16_t x );
+
+    /**
+     * Medians with sorting networks (3 / 7 compare-exchange steps)
+     **/
+    uint16_t FILTER_Median3( uint16_t a, uint16_t b, uint16_t c );
+    uint16_t FILTER_Median5( const uint16_t *p );
+
+    /**
+     * Initialize the median window with 'initial', add a sample and return
+     * the median of the window
+     **/
+    void FILTER_MedianInitialize( filter_median_t *f, uint16_t initial );
+    uint16_t FILTER_MedianPut( filter_median_t *f, uint16_t x );
+
+    /**
+     * Start a new min/max tracking, add a sample
+     **/
+    void FILTER_MinMaxReset( filter_minmax_t *f );
+    void FILTER_MinMaxPut( filter_minmax_t *f, uint16_t x );
+
+    /**
+     * Peak to peak amplitude of the tracked samples
+     **/
+    #define FILTER_MinMaxRange( f )     ( (uint16_t)((f)->max - (f)->min) )
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FILTER_H */
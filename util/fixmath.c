@@ -0,0 +1,264 @@
+/*
+ * File:   fixmath.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the fixed point routines (see fixmath.h).
+ *  Signed operations work on the magnitudes (unsigned) and set the sign at
+ * the end. The saturation limit depends on the sign of the result: 0x7FFF
+ * for positive results and 0x8000 for negative results (Q8.8), the same on
+ * 32 bits for Q16.16.
+ */
+
+#include <stdint.h>
+#include "fixmath.h"
+#include "utils.h"
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+#if FIXMATH_STATS == 1
+fixmath_stats_t fixmath_stats;
+#define fix_Stat( f )   ( fixmath_stats.f++ )
+#else
+#define fix_Stat( f )
+#endif
+
+/**
+ * Saturation limits of the magnitude of a result
+ **/
+#define fix_Limit16( neg )  ( (neg) ? 0x8000u : 0x7FFFu )
+#define fix_Limit32( neg )  ( (neg) ? 0x80000000ul : 0x7FFFFFFFul )
+
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+/**
+ * Magnitude of x (valid for INT16_MIN / INT32_MIN too)
+ **/
+#define fix_Abs16( x )  ( (x) < 0 ? (uint16_t)(0u - (uint16_t)(x)) : (uint16_t)(x) )
+#define fix_Abs32( x )  ( (x) < 0 ? (uint32_t)(0u - (uint32_t)(x)) : (uint32_t)(x) )
+
+/**
+ * Quotient (n << frac) / d rounded to nearest, n < 2^bits. Return max if d
+ * is zero or the quotient is above max. d <= 2^31.
+ **/
+static uint32_t fix_UDiv( uint32_t n, uint32_t d, uint8_t bits, uint8_t frac,
+                          uint32_t max ){
+    uint32_t q = 0u, r = 0u;
+    uint8_t steps = bits + frac;
+
+    if( d == 0u )
+        return max;
+
+    n <<= (uint8_t)(32u - bits);            // first bit of n on bit 31
+    while( steps-- ){
+        // next bit of the dividend (zeros after the n bits)
+        r = (r << 1) | (n >> 31);
+        n <<= 1;
+        if( q > (max >> 1) )                // the next quotient is > max
+            return max;
+        q <<= 1;
+        if( r >= d ){
+            r -= d;
+            q |= 1u;
+        }
+        fix_Stat( div );
+    }
+    if( r >= d - r )                        // remainder >= d / 2
+        q++;
+    return (q > max) ? max : q;
+}
+
+/**
+ * Floor of the square root of *x, *x is replaced by the remainder
+ * (x - root^2)
+ **/
+static uint16_t fix_SqrtRem( uint32_t *x ){
+    uint32_t v = *x, r = 0u, bit = 1ul << 30;
+
+    while( bit > v )
+        bit >>= 2;
+    while( bit ){
+        if( v >= r + bit ){
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+            r >>= 1;
+        bit >>= 2;
+        fix_Stat( sqrt );
+    }
+    *x = v;
+    return (uint16_t)r;
+}
+
+/******************************************************************************
+ ************************* Section: Products **********************************
+ ******************************************************************************/
+
+uint16_t FIX_Mul8x8( uint8_t a, uint8_t b ){
+    uint16_t r = 0u, x;
+
+    // one step per bit of the smaller operand
+    if( a < b ){
+        x = b;
+        b = a;
+    }
+    else
+        x = a;
+
+    while( b ){
+        if( b & 1u )
+            r += x;
+        x <<= 1;
+        b >>= 1;
+        fix_Stat( mul );
+    }
+    return r;
+}
+
+uint32_t FIX_Mul16x16( uint16_t a, uint16_t b ){
+    uint8_t al = BYTE_GetByte( a, 0u ), ah = BYTE_GetByte( a, 1u );
+    uint8_t bl = BYTE_GetByte( b, 0u ), bh = BYTE_GetByte( b, 1u );
+    uint32_t r;
+
+    // four 8x8 partial products (a zero byte costs no steps)
+    r = ((uint32_t)FIX_Mul8x8( ah, bh ) << 16) | FIX_Mul8x8( al, bl );
+    r += (uint32_t)FIX_Mul8x8( al, bh ) << 8;
+    r += (uint32_t)FIX_Mul8x8( ah, bl ) << 8;
+    return r;
+}
+
+/******************************************************************************
+ ************************* Section: Q8.8 APIs *********************************
+ ******************************************************************************/
+
+q8_8_t FIX_Mul8_8( q8_8_t a, q8_8_t b ){
+    uint8_t neg = (a < 0) != (b < 0);
+    uint32_t p = FIX_Mul16x16( fix_Abs16( a ), fix_Abs16( b ) );
+    uint16_t max = fix_Limit16( neg );
+
+    p = (p + 0x80u) >> 8;
+    if( p > max )
+        p = max;
+    return neg ? (q8_8_t)(0u - (uint16_t)p) : (q8_8_t)p;
+}
+
+q8_8_t FIX_Div8_8( q8_8_t a, q8_8_t b ){
+    uint8_t neg = (a < 0) != (b < 0);
+    uint16_t q = (uint16_t)fix_UDiv( fix_Abs16( a ), fix_Abs16( b ), 16u, 8u,
+                                     fix_Limit16( neg ) );
+
+    return neg ? (q8_8_t)(0u - q) : (q8_8_t)q;
+}
+
+q8_8_t FIX_AddSat8_8( q8_8_t a, q8_8_t b ){
+    uint16_t r = (uint16_t)a + (uint16_t)b;
+
+    // overflow: operands with the same sign and result with the other one
+    if( ((uint16_t)a ^ r) & ((uint16_t)b ^ r) & 0x8000u )
+        return (a < 0) ? INT16_MIN : INT16_MAX;
+    return (q8_8_t)r;
+}
+
+q8_8_t FIX_Recip8_8( q8_8_t x ){
+    return FIX_Div8_8( FIX_Q8_8( 1 ), x );
+}
+
+q8_8_t FIX_Sqrt8_8( q8_8_t x ){
+    uint32_t v;
+    uint16_t r;
+
+    if( x <= 0 )
+        return 0;
+    // sqrt( x / 256 ) * 256 = sqrt( x * 256 )
+    v = (uint32_t)x << 8;
+    r = fix_SqrtRem( &v );
+    if( v > r )                             // (r + 0.5)^2 = r^2 + r + 0.25
+        r++;
+    return (q8_8_t)r;
+}
+
+/******************************************************************************
+ ************************ Section: Q16.16 APIs ********************************
+ ******************************************************************************/
+
+q16_16_t FIX_Mul16_16( q16_16_t a, q16_16_t b ){
+    uint8_t neg = (a < 0) != (b < 0);
+    uint32_t ua = fix_Abs32( a ), ub = fix_Abs32( b );
+    uint16_t ah = (uint16_t)(ua >> 16), al = (uint16_t)ua;
+    uint16_t bh = (uint16_t)(ub >> 16), bl = (uint16_t)ub;
+    uint32_t max = fix_Limit32( neg );
+    uint32_t r;
+
+    // (a * b) >> 16 = ah*bh << 16 + ah*bl + al*bh + (al*bl + 0.5) >> 16
+    // every term is < 2^31, so the sum is checked after every add
+    r = FIX_Mul16x16( ah, bh );
+    if( r >= 0x8000u )
+        return neg ? INT32_MIN : INT32_MAX;
+    r <<= 16;
+    r += FIX_Mul16x16( ah, bl );
+    if( r > max )
+        r = max;
+    r += FIX_Mul16x16( al, bh );
+    if( r > max )
+        r = max;
+    r += (FIX_Mul16x16( al, bl ) + 0x8000u) >> 16;
+    if( r > max )
+        r = max;
+    return neg ? (q16_16_t)(0u - r) : (q16_16_t)r;
+}
+
+q16_16_t FIX_Div16_16( q16_16_t a, q16_16_t b ){
+    uint8_t neg = (a < 0) != (b < 0);
+    uint32_t q = fix_UDiv( fix_Abs32( a ), fix_Abs32( b ), 32u, 16u,
+                           fix_Limit32( neg ) );
+
+    return neg ? (q16_16_t)(0u - q) : (q16_16_t)q;
+}
+
+q16_16_t FIX_AddSat16_16( q16_16_t a, q16_16_t b ){
+    uint32_t r = (uint32_t)a + (uint32_t)b;
+
+    if( ((uint32_t)a ^ r) & ((uint32_t)b ^ r) & 0x80000000ul )
+        return (a < 0) ? INT32_MIN : INT32_MAX;
+    return (q16_16_t)r;
+}
+
+q16_16_t FIX_Recip16_16( q16_16_t x ){
+    return FIX_Div16_16( FIX_Q16_16( 1 ), x );
+}
+
+/******************************************************************************
+ ********************** Section: Other Routines *******************************
+ ******************************************************************************/
+
+uint16_t FIX_ISqrt( uint32_t x ){
+    return fix_SqrtRem( &x );
+}
+
+int16_t FIX_Lerp( int16_t a, int16_t b, uint16_t t ){
+    int32_t d = (int32_t)b - a;
+    uint16_t p = (uint16_t)((FIX_Mul16x16( fix_Abs32( d ), t ) + 0x80u) >> 8);
+
+    return (int16_t)( (d < 0) ? a - p : a + p );
+}
+
+int16_t FIX_Interpolate( const int16_t *table, uint8_t len, uint16_t x, uint8_t shift ){
+    uint16_t i = x >> shift;
+    uint16_t f = x - (i << shift);
+    int32_t d;
+    uint32_t p;
+
+    if( i >= (uint16_t)(len - 1u) )
+        return table[len - 1u];
+
+    d = (int32_t)table[i + 1u] - table[i];
+    p = FIX_Mul16x16( fix_Abs32( d ), f );
+    if( shift )
+        p = (p + (1ul << (shift - 1u))) >> shift;
+    return (int16_t)( (d < 0) ? table[i] - (int16_t)p : table[i] + (int16_t)p );
+}
@@ -0,0 +1,132 @@
+/*
+ * File:   fixmath.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Fixed point arithmetic for the PIC16 (no hardware multiplier), as a
+ * replacement of the software float library for sensor scaling and control:
+ *  - Q8.8:   int16_t, value = x / 256    (range -128 .. 127.996)
+ *  - Q16.16: int32_t, value = x / 65536  (range -32768 .. 32767.99998)
+ *  The same representation is printed by q8_8_2str and q16_16_2str (see
+ * num2str.h).
+ *  The routines do not use the '*', '/' or '%' operators on variables, so
+ * the compiler multiply and divide helpers are not linked: products are
+ * made of 8x8 shift-and-add multiplies and quotients of shift-and-subtract
+ * steps. Results are rounded to nearest and saturated to the range of the
+ * type (a division by zero returns the maximum with the sign of the
+ * dividend).
+ *
+ * @Example
+ * <code>
+ *  // LM335 (10mV/K) on a 10 bits ADC with Vref = 5V:
+ *  // T = counts * 500 / 1024 - 273.15
+ *  q16_16_t t = FIX_Mul16_16( FIX_ToQ16_16( counts ), FIX_Q16_16( 500.0 / 1024.0 ) )
+ *               - FIX_Q16_16( 273.15 );
+ *  q16_16_2str( t, 1, buf );
+ * </code>
+ */
+
+#ifndef FIXMATH_H
+#define	FIXMATH_H
+
+#include <stdint.h>
+
+/**
+ * FIXMATH_STATS
+ *
+ * @Description
+ *  When 1, the routines count their loop steps on fixmath_stats (multiply
+ * add steps, divide steps and square root steps). It is used for compare
+ * implementations on a host build (see README), keep it at 0 on the target.
+ **/
+#ifndef FIXMATH_STATS
+#define FIXMATH_STATS 0
+#endif
+
+typedef int16_t q8_8_t;
+typedef int32_t q16_16_t;
+
+/**
+ * Constant conversion (computed by the compiler, use them with constants)
+ * Ej: FIX_Q8_8( 1.5 ) = 384
+ **/
+#define FIX_Q8_8( x )       ((q8_8_t)((x) * 256.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define FIX_Q16_16( x )     ((q16_16_t)((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+/**
+ * Integer to fixed point and back (integer part, rounded towards -infinity)
+ **/
+#define FIX_ToQ8_8( i )     ((q8_8_t)((uint16_t)(i) << 8))
+#define FIX_ToQ16_16( i )   ((q16_16_t)((uint32_t)(i) << 16))
+#define FIX_IntQ8_8( x )    ((int8_t)((x) >> 8))
+#define FIX_IntQ16_16( x )  ((int16_t)((x) >> 16))
+
+#if FIXMATH_STATS == 1
+/**
+ * Step counters (see FIXMATH_STATS). Clear them before a call and read them
+ * after it.
+ **/
+typedef struct{
+    uint32_t mul;       // 8x8 multiply add steps
+    uint32_t div;       // shift-and-subtract steps
+    uint32_t sqrt;      // square root steps
+} fixmath_stats_t;
+
+extern fixmath_stats_t fixmath_stats;
+#endif
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    /**
+     * Unsigned products: 8x8 -> 16 bits and 16x16 -> 32 bits
+     **/
+    uint16_t FIX_Mul8x8( uint8_t a, uint8_t b );
+    uint32_t FIX_Mul16x16( uint16_t a, uint16_t b );
+
+    /**
+     * Multiply and divide (rounded, saturated)
+     **/
+    q8_8_t FIX_Mul8_8( q8_8_t a, q8_8_t b );
+    q8_8_t FIX_Div8_8( q8_8_t a, q8_8_t b );
+    q16_16_t FIX_Mul16_16( q16_16_t a, q16_16_t b );
+    q16_16_t FIX_Div16_16( q16_16_t a, q16_16_t b );
+
+    /**
+     * Saturating add (a + b clamped to the range of the type)
+     **/
+    q8_8_t FIX_AddSat8_8( q8_8_t a, q8_8_t b );
+    q16_16_t FIX_AddSat16_16( q16_16_t a, q16_16_t b );
+
+    /**
+     * Reciprocal 1 / x (rounded, saturated)
+     **/
+    q8_8_t FIX_Recip8_8( q8_8_t x );
+    q16_16_t FIX_Recip16_16( q16_16_t x );
+
+    /**
+     * Square root: integer (floor) of a 32 bits value, and of a Q8.8 value
+     * (negative values return 0)
+     **/
+    uint16_t FIX_ISqrt( uint32_t x );
+    q8_8_t FIX_Sqrt8_8( q8_8_t x );
+
+    /**
+     * Linear interpolation between a and b, t = 0 .. 256 (Q0.8): a + (b - a) * t
+     **/
+    int16_t FIX_Lerp( int16_t a, int16_t b, uint16_t t );
+
+    /**
+     * Linear interpolation on a const table of 'len' points equally spaced
+     * 2^shift input units (the point i is the output for x = i << shift).
+     * Inputs after the last point return the last point.
+     *  Ej: a 10 bits ADC with 17 points, shift = 6 (every 64 counts).
+     **/
+    int16_t FIX_Interpolate( const int16_t *table, uint8_t len, uint16_t x, uint8_t shift );
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FIXMATH_H */
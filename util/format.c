@@ -0,0 +1,147 @@
+/*
+ * File:   format.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the op list formatter (see format.h).
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include "format.h"
+#include "num2str.h"
+
+/******************************************************************************
+ ************************** Section: Data Types *******************************
+ ******************************************************************************/
+
+/**
+ * Print state, on the stack of every API call (reentrant, like num2str)
+ **/
+typedef struct{
+    const num2str_sink_t *sink;     // output sink
+    uint8_t count;                  // characters sent
+} fmt_t;
+
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+static void fmt_Put( fmt_t *f, char c ){
+    f->sink->Put( f->sink->ctx, c );
+    f->count++;
+}
+
+/**
+ * Put n characters of s inside a field of 'width' characters (a minimum:
+ * with n > width the n characters are put, see format.h)
+ **/
+static void fmt_PutField( fmt_t *f, const char *s, uint8_t n, uint8_t width ){
+    uint8_t left = width & FMT_ALIGN_LEFT;
+    uint8_t fill = 0u;
+
+    width &= FMT_WIDTH_MASK;
+    if( width > n )
+        fill = width - n;
+
+    if( !left ){
+        while( fill ){
+            fmt_Put( f, ' ' );
+            fill--;
+        }
+    }
+    while( n ){
+        fmt_Put( f, *s++ );
+        n--;
+    }
+    while( fill ){
+        fmt_Put( f, ' ' );
+        fill--;
+    }
+}
+
+/**
+ * Run the op list
+ **/
+static void fmt_Run( fmt_t *f, const fmt_op_t *op, va_list ap ){
+    for( ; op->type != FMT_TYPE_END; op++ ){
+        uint8_t width = op->width & (uint8_t)~FMT_PAD_ZERO;
+        char pad = (op->width & FMT_PAD_ZERO) ? '0' : ' ';
+        uint8_t isLong = op->type & FMT_FLAG_LONG;
+
+        switch( op->type & FMT_TYPE_MASK ){
+            case FMT_TYPE_TEXT:
+                for( const char *s = op->text; *s; s++ )
+                    fmt_Put( f, *s );
+                break;
+
+            case FMT_TYPE_STR:{
+                const char *s = va_arg( ap, const char* );
+                const char *e = s;
+                while( *e )
+                    e++;
+                fmt_PutField( f, s, (uint8_t)(e - s), op->width );
+                break;
+            }
+
+            case FMT_TYPE_CHAR:{
+                char c = (char)va_arg( ap, int );
+                fmt_PutField( f, &c, 1u, op->width );
+                break;
+            }
+
+            case FMT_TYPE_FIX:
+                f->count += fix2sink( va_arg( ap, int32_t ), op->decimals,
+                                       width, pad, f->sink );
+                break;
+
+            case FMT_TYPE_INT:{
+                int32_t x = isLong ? va_arg( ap, int32_t )
+                                   : (int16_t)va_arg( ap, int );
+                f->count += long2sink( x, 10u, width, pad, f->sink );
+                break;
+            }
+
+            case FMT_TYPE_UINT:
+            case FMT_TYPE_HEX:{
+                uint8_t bas = ((op->type & FMT_TYPE_MASK) == FMT_TYPE_HEX) ? 16u : 10u;
+                uint32_t x = isLong ? va_arg( ap, uint32_t )
+                                    : (uint16_t)va_arg( ap, unsigned int );
+                f->count += ulong2sink( x, bas, width, pad, f->sink );
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+/******************************************************************************
+ ************************* Section: Format APIs *******************************
+ ******************************************************************************/
+
+uint8_t FMT_Sprint( char *res, const fmt_op_t *ops, ... ){
+    char *cursor = res;
+    const num2str_sink_t buffer = { NUM2STR_BufferPut, &cursor };
+    fmt_t f = { &buffer, 0u };
+    va_list ap;
+
+    va_start( ap, ops );
+    fmt_Run( &f, ops, ap );
+    va_end( ap );
+
+    *cursor = '\0';
+    return f.count;
+}
+
+uint8_t FMT_Print( const num2str_sink_t *sink, const fmt_op_t *ops, ... ){
+    fmt_t f = { sink, 0u };
+    va_list ap;
+
+    va_start( ap, ops );
+    fmt_Run( &f, ops, ap );
+    va_end( ap );
+
+    return f.count;
+}
@@ -0,0 +1,124 @@
+/*
+ * File:   format.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Small formatter (subset of printf) built over the num2str routines.
+ *  The format is not a string: it is a const list of operations written with
+ * the FMT_xxx macros, so nothing is parsed at run time and the list is
+ * stored on program memory.
+ *
+ *    printf    | Operation
+ *  ------------+------------------------------------------------------------
+ *    text      | FMT_TEXT( "text" )
+ *    %d  %ld   | FMT_D( w )  FMT_LD( w )    int / int32_t argument
+ *    %u  %lu   | FMT_U( w )  FMT_LU( w )    unsigned / uint32_t argument
+ *    %X  %lX   | FMT_X( w )  FMT_LX( w )    unsigned / uint32_t argument
+ *    %s        | FMT_S( w )                 const char* argument
+ *    %c        | FMT_C( w )                 char argument
+ *    -         | FMT_FIX( w, d )            int32_t argument, printed as
+ *              |                            x * 10^-d (see fix2str)
+ *    (end)     | FMT_END                    must close every list
+ *
+ *  The width 'w' (0 to 63, 0: natural size) means a different thing for
+ * numbers and for text:
+ *  - FMT_D, FMT_LD, FMT_U, FMT_LU, FMT_X, FMT_LX and FMT_FIX: exact field
+ *    size. The number is padded up to w characters, and a number that does
+ *    not fit is printed as w NUM2STR_OVERFLOW_CHAR characters (unlike
+ *    printf, see the fixed size fields of num2str.h): the field is always w
+ *    characters, so a LCD line does not move.
+ *  - FMT_S and FMT_C: minimum field size, as printf. The text is padded up
+ *    to w characters with spaces, and a longer string is printed whole
+ *    (the field grows past w).
+ *  It can be combined with:
+ *  - FMT_PAD_ZERO: pad numbers with '0' instead of spaces (%05d), no effect
+ *    on text.
+ *  - FMT_ALIGN_LEFT: left alignment (%-5d, %-8s).
+ *  Numbers are sent straight to the output sink (see num2str_sink_t), no
+ * scratch buffer is needed.
+ *
+ * @Example
+ * <code>
+ *  // "T=%5.1fC %04X"
+ *  static const fmt_op_t fmtStatus[] = {
+ *      FMT_TEXT( "T=" ), FMT_FIX( 5, 1 ), FMT_TEXT( "C " ),
+ *      FMT_X( 4 | FMT_PAD_ZERO ), FMT_END
+ *  };
+ *  char line[17];
+ *
+ *  FMT_Sprint( line, fmtStatus, (int32_t)253, 0x1Fu ); // "T= 25.3C 001F"
+ *  FMT_Print( &LCD_Sink, fmtStatus, (int32_t)253, 0x1Fu );
+ * </code>
+ */
+
+#ifndef FORMAT_H
+#define	FORMAT_H
+
+#include <stdint.h>
+#include "num2str.h"
+
+/**
+ * Width flags
+ **/
+#define FMT_ALIGN_LEFT  NUM2STR_ALIGN_LEFT  // 0x80
+#define FMT_PAD_ZERO    0x40u
+#define FMT_WIDTH_MASK  0x3Fu
+
+/**
+ * Operation types (don't use directly, see FMT_xxx macros)
+ **/
+#define FMT_TYPE_END    0x00u
+#define FMT_TYPE_TEXT   0x01u
+#define FMT_TYPE_INT    0x02u
+#define FMT_TYPE_UINT   0x03u
+#define FMT_TYPE_HEX    0x04u
+#define FMT_TYPE_STR    0x05u
+#define FMT_TYPE_CHAR   0x06u
+#define FMT_TYPE_FIX    0x07u
+#define FMT_TYPE_MASK   0x0Fu
+#define FMT_FLAG_LONG   0x10u   // 32 bits argument
+
+/**
+ * One operation of a format list
+ **/
+typedef struct{
+    uint8_t type;       // FMT_TYPE_xxx | FMT_FLAG_xxx
+    uint8_t width;      // field width | FMT_ALIGN_LEFT | FMT_PAD_ZERO
+    uint8_t decimals;   // FMT_FIX decimals
+    const char *text;   // FMT_TEXT text
+} fmt_op_t;
+
+#define FMT_END             { FMT_TYPE_END, 0u, 0u, 0 }
+#define FMT_TEXT( s )       { FMT_TYPE_TEXT, 0u, 0u, (s) }
+#define FMT_D( w )          { FMT_TYPE_INT, (w), 0u, 0 }
+#define FMT_LD( w )         { FMT_TYPE_INT | FMT_FLAG_LONG, (w), 0u, 0 }
+#define FMT_U( w )          { FMT_TYPE_UINT, (w), 0u, 0 }
+#define FMT_LU( w )         { FMT_TYPE_UINT | FMT_FLAG_LONG, (w), 0u, 0 }
+#define FMT_X( w )          { FMT_TYPE_HEX, (w), 0u, 0 }
+#define FMT_LX( w )         { FMT_TYPE_HEX | FMT_FLAG_LONG, (w), 0u, 0 }
+#define FMT_S( w )          { FMT_TYPE_STR, (w), 0u, 0 }
+#define FMT_C( w )          { FMT_TYPE_CHAR, (w), 0u, 0 }
+#define FMT_FIX( w, d )     { FMT_TYPE_FIX, (w), (d), 0 }
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    /**
+     * Format the arguments on 'res' following the 'ops' list. The string is
+     * null terminated. Return the amount of characters written (without the
+     * null character).
+     **/
+    uint8_t FMT_Sprint( char *res, const fmt_op_t *ops, ... );
+
+    /**
+     * Format the arguments following the 'ops' list sending every character
+     * to 'sink' (Ej: &LCD_Sink). Return the amount of characters sent.
+     **/
+    uint8_t FMT_Print( const num2str_sink_t *sink, const fmt_op_t *ops, ... );
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FORMAT_H */
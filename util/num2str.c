@@ -1,164 +1,877 @@
-/* 
+/*
  * File:   num2str.c
  * Author: Jose Guerra Carmenate
  *
  * Created on 5 de enero de 2019, 20:18
  * @Description
- *  This header contain a set of routines implementations for store numbers on 
+ *  This header contain a set of routines implementations for store numbers on
  * string.
+ *  The conversion engine does not use the '/' or '%' operators, so the
+ * compiler software division helpers are not linked:
+ *   - Decimal digits are obtained subtracting powers of ten (most significant
+ *     digit first). Values that fit on 16 bits use 16 bits arithmetic only.
+ *   - Bases 2, 4, 8 and 16 extract every digit with shifts and masks.
+ *   - Other bases use a shift-and-subtract division by the (8 bits) base.
+ *  The characters are produced in order (most significant first), so they
+ * can be sent to a character sink without an intermediate buffer.
  */
 
 #include <stdint.h>
+#include <stddef.h>
 #include "num2str.h"
+#include "utils.h"
+#include "profile.h"
 
-uint8_t short2str( int8_t x, uint8_t bas, char *p ){
-    int8_t xx = x;
-    
-    do{
-        p++;
-        xx /= bas;
-    }while( xx );
-    
-    if( x < 0 ){
-        *(p++) = '-';
-        x *= -1;
-        xx++;
+/******************************************************************************
+ ************************** Section: Data Types *******************************
+ ******************************************************************************/
+
+/**
+ * Conversion state. Every API routine keeps its own on the stack, so the
+ * routines are reentrant: a conversion on the ISR does not corrupt one in
+ * progress on the main code (XC8 duplicates the code called from both).
+ **/
+typedef struct{
+    char *cursor;                   // next position to write (buffer)
+    const num2str_sink_t *sink;     // character sink, NULL: buffer
+    uint8_t count;                  // characters written
+    uint8_t point;                  // decimal digits before the '.' (0: none)
+    PROFILE_START_VAR( start )      // PROFILE_ID_NUM2STR measure
+} n2s_t;
+
+/**
+ * Digits of a generic base (not 10 nor a power of two), less significant
+ * first: computed by n2s_Len, put by n2s_Digits. 0xFFFFFFFF has 21 digits
+ * on base 3.
+ **/
+#define N2S_RADIX_DIGITS    21u
+
+typedef struct{
+    uint8_t len;
+    uint8_t d[N2S_RADIX_DIGITS];
+} n2s_radix_t;
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+/**
+ * Powers of ten used by the decimal conversion of 32 bits values
+ **/
+static const uint32_t n2s_pow10[] = {
+    1000000000ul, 100000000ul, 10000000ul, 1000000ul, 100000ul,
+    10000ul, 1000ul, 100ul, 10ul, 1ul
+};
+
+/**
+ * Powers of ten used by the decimal conversion of 16 bits values
+ **/
+static const uint16_t n2s_pow10_16[] = { 10000u, 1000u, 100u, 10u, 1u };
+
+/**
+ * Digit to character map (digits above 9 are printed as 'A'-'F')
+ **/
+static const char n2s_digits[] = "0123456789ABCDEF";
+
+#if NUM2STR_DEC_PAIRS == 1
+/**
+ * Characters of the decimal pairs 00 to 99 (pair n at index 2n)
+ **/
+static const char n2s_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+#endif
+
+
+#if NUM2STR_STATS == 1
+num2str_stats_t num2str_stats;
+#define n2s_Stat( f )   ( num2str_stats.f++ )
+#else
+#define n2s_Stat( f )
+#endif
+
+/**
+ * Put one character on the buffer or on the sink
+ **/
+#define n2s_Put( s, c )     do{                                 \
+            if( (s)->sink == NULL )                             \
+                *(s)->cursor++ = (char)(c);                     \
+            else                                                \
+                (s)->sink->Put( (s)->sink->ctx, (char)(c) );    \
+            (s)->count++;                                       \
+            n2s_Stat( put );                                    \
+        }while(0)
+
+/**
+ * Put one decimal digit, and the decimal point after the point-th digit
+ **/
+#define n2s_PutDigit( s, c )    do{                     \
+            n2s_Put( s, c );                            \
+            if( --(s)->point == 0u )                    \
+                n2s_Put( s, '.' );                      \
+        }while(0)
+
+/**
+ * Start the conversion on buffer p / on sink k, and finish it
+ **/
+#define n2s_Begin( s, p )       do{ PROFILE_START( (s)->start );            \
+                                    (s)->cursor = (p); (s)->sink = NULL;    \
+                                    (s)->count = 0u; (s)->point = 0u; }while(0)
+#define n2s_BeginSink( s, k )   do{ PROFILE_START( (s)->start );            \
+                                    (s)->sink = (k);                        \
+                                    (s)->count = 0u; (s)->point = 0u; }while(0)
+#define n2s_End( s )            ( PROFILE_STOP( PROFILE_ID_NUM2STR, (s)->start ), (s)->count )
+
+/******************************************************************************
+ ********************** Section: Conversion Engine ****************************
+ ******************************************************************************/
+
+/**
+ * Return the number of decimal digits of x (16 bits)
+ **/
+static uint8_t n2s_DecLen16( uint16_t x ){
+    const uint16_t *pw = n2s_pow10_16;
+    uint8_t len = 5u;
+
+    while( len > 1u && x < *pw ){
+        pw++;
+        len--;
+    }
+    return len;
+}
+
+/**
+ * Return the number of decimal digits of x (32 bits)
+ **/
+static uint8_t n2s_DecLen( uint32_t x ){
+    const uint32_t *pw = n2s_pow10;
+    uint8_t len = 10u;
+
+    while( len > 1u && x < *pw ){
+        pw++;
+        len--;
+    }
+    return len;
+}
+
+/**
+ * Put the 'len' less significant decimal digits of x (x < 10^len, len <= 5)
+ **/
+#if NUM2STR_DEC_PAIRS == 1
+static void n2s_Dec16( n2s_t *s, uint16_t x, uint8_t len ){
+    const uint16_t *pw = n2s_pow10_16 + (5u - len);
+
+    if( len == 1u ){
+        n2s_PutDigit( s, (char)x + '0' );
+        return;
+    }
+    if( len & 1u ){             // odd length: the first digit alone
+        char d = '0';
+        while( x >= *pw ){
+            x -= *pw;
+            d++;
+            n2s_Stat( subtract );
+        }
+        n2s_PutDigit( s, d );
+        pw++;
+        len--;
+    }
+
+    while( len ){
+        uint16_t w = pw[1] << 6;    // 64 * weight of the pair
+        uint8_t q = 0u;
+        uint8_t bit = 64u;
+
+        do{                         // pair = x / weight, bit by bit
+            if( x >= w ){
+                x -= w;
+                q |= bit;
+            }
+            w >>= 1;
+            n2s_Stat( subtract );
+        }while( bit >>= 1 );
+
+        q <<= 1;
+        n2s_PutDigit( s, n2s_pairs[q] );
+        n2s_PutDigit( s, n2s_pairs[q + 1u] );
+        pw += 2;
+        len -= 2u;
+    }
+}
+#else
+static void n2s_Dec16( n2s_t *s, uint16_t x, uint8_t len ){
+    const uint16_t *pw = n2s_pow10_16 + (5u - len);
+
+    while( --len ){
+        char d = '0';
+        while( x >= *pw ){      // digit = how many times the power fits
+            x -= *pw;
+            d++;
+            n2s_Stat( subtract );
+        }
+        n2s_PutDigit( s, d );
+        pw++;
+    }
+    n2s_PutDigit( s, (char)x + '0' );  // units
+}
+#endif
+
+/**
+ * Put the 'len' less significant decimal digits of x (x < 10^len, len <= 10)
+ **/
+static void n2s_Dec( n2s_t *s, uint32_t x, uint8_t len ){
+    const uint32_t *pw = n2s_pow10 + (10u - len);
+
+    // use 32 bits arithmetic only while the remainder can exceed 16 bits
+    while( len > 4u ){
+        char d = '0';
+        while( x >= *pw ){
+            x -= *pw;
+            d++;
+            n2s_Stat( subtract );
+        }
+        n2s_PutDigit( s, d );
+        pw++;
+        len--;
     }
-    
-    //*p = '\0';
-    
+    n2s_Dec16( s, (uint16_t)x, len );
+}
+
+/**
+ * Divide *x by bas (shift-and-subtract) and return the remainder
+ **/
+static uint8_t n2s_DivMod( uint32_t *x, uint8_t bas ){
+    uint32_t q = *x;
+    uint8_t r = 0u;
+    uint8_t i = 32u;
+
     do{
-        *(--p) = (uint8_t)(x%bas) + '0';
-        x /= bas;
-        xx++;
-    }while( x );
-    
-    return (uint8_t)xx;
+        r = (uint8_t)(r << 1) | (uint8_t)(q >> 31);  // bring down next bit
+        q <<= 1;
+        if( r >= bas ){
+            r -= bas;
+            q |= 1u;                                 // quotient bit
+        }
+        n2s_Stat( divide );
+    }while( --i );
+
+    *x = q;
+    return r;
 }
 
-uint8_t int2str( int16_t x, uint8_t bas, char *p ){
-    int16_t xx = x;
-    if( x < 0 )
-        *p++ = '-';
+/**
+ * Compute the digits of x on any base in range [2-16] (one division per
+ * digit, no multiply) and return the number of digits
+ **/
+static uint8_t n2s_RadixLen( uint32_t x, uint8_t bas, n2s_radix_t *r ){
+    uint8_t len = 0u;
+
+    while( x >= bas )
+        r->d[len++] = n2s_DivMod( &x, bas );
+    r->d[len++] = (uint8_t)x;
+    r->len = len;
+    return len;
+}
+
+/**
+ * Put the digits computed by n2s_RadixLen on 'len' digits (leading zeros)
+ **/
+static void n2s_Radix( n2s_t *s, const n2s_radix_t *r, uint8_t len ){
+    uint8_t i = r->len;
+
+    while( len > i ){
+        n2s_Put( s, '0' );
+        len--;
+    }
     do{
-        p++;
-        xx /= bas;
-    }while( xx );
-    
-    if( x < 0 ){
-        x *= -1;
-        xx++;
+        n2s_Put( s, n2s_digits[r->d[--i]] );
+    }while( i );
+}
+
+/**
+ * Return log2(bas) for the bases 2, 4, 8 and 16, or 0 for any other base
+ **/
+static uint8_t n2s_Shift( uint8_t bas ){
+    switch( bas ){
+        case 2u:  return 1u;
+        case 4u:  return 2u;
+        case 8u:  return 3u;
+        case 16u: return 4u;
+        default:  return 0u;
+    }
+}
+
+/**
+ * Return the number of digits of x on base 2^k
+ **/
+static uint8_t n2s_Pow2Len( uint32_t x, uint8_t k ){
+    uint8_t bits = 32u;     // significant bits of x
+    uint8_t len = 1u;
+
+    if( x == 0u )
+        return 1u;
+    while( (uint8_t)(x >> 24) == 0u ){  // skip zero bytes
+        x <<= 8;
+        bits -= 8u;
+    }
+    while( (uint8_t)(x >> 31) == 0u ){
+        x <<= 1;
+        bits--;
+    }
+    while( bits > k ){
+        bits -= k;
+        len++;
     }
-    
-    //*p = '\0';
-    
+    return len;
+}
+
+/**
+ * Put the 'len' digits of x on base 16, one nibble at time
+ **/
+static void n2s_Hex( n2s_t *s, uint32_t x, uint8_t len ){
+    uint8_t n = 8u - len;   // nibbles to skip
+
+    while( n >= 2u ){
+        x <<= 8;
+        n -= 2u;
+    }
+    if( n )
+        x <<= 4;
+
     do{
-        *(--p) = (uint8_t)(x%bas) + '0';
-        x /= bas;
-        xx++;
-    }while( x );
-    
-    return (uint8_t)xx;
+        n2s_Put( s, n2s_digits[ BYTE_GetNibble4to8( (uint8_t)(x >> 24) ) ] );
+        x <<= 4;
+        n2s_Stat( shift );
+    }while( --len );
 }
 
-uint8_t long2str( int32_t x, uint8_t bas, char *p ){
-    
-    int32_t xx = x;
-    
+/**
+ * Put the 'len' digits of x on base 2^k (k = 1, 2 or 3) shifting out the
+ * bits from the most significant side
+ **/
+static void n2s_Pow2( n2s_t *s, uint32_t x, uint8_t k, uint8_t len ){
+    uint8_t bits = (uint8_t)(len * k);
+    uint8_t b = k;          // bits of the current digit
+
+    if( bits > 32u ){       // octal: the first digit has less than 3 bits
+        b -= bits - 32u;
+        bits = 32u;
+    }
+    x <<= (uint8_t)(32u - bits);
+
     do{
-        p++;
-        xx /= bas;
-    }while( xx );
-    
+        uint8_t d = 0u;
+        do{
+            d = (uint8_t)(d << 1) | (uint8_t)(x >> 31);
+            x <<= 1;
+            n2s_Stat( shift );
+        }while( --b );
+        b = k;
+        n2s_Put( s, n2s_digits[d] );
+    }while( --len );
+}
+
+/**
+ * Return the number of digits of x on base bas. The digits of a generic
+ * base are computed here, on r.
+ **/
+static uint8_t n2s_Len( uint32_t x, uint8_t bas, n2s_radix_t *r ){
+    uint8_t k;
+
+    if( bas == 10u ){
+        if( x < 0x10000ul )
+            return n2s_DecLen16( (uint16_t)x );
+        return n2s_DecLen( x );
+    }
+    k = n2s_Shift( bas );
+    if( k )
+        return n2s_Pow2Len( x, k );
+    return n2s_RadixLen( x, bas, r );
+}
+
+/**
+ * Put the 'len' digits of x on base bas (x < bas^len), r: see n2s_Len
+ **/
+static void n2s_Digits( n2s_t *s, uint32_t x, uint8_t bas, uint8_t len,
+                        const n2s_radix_t *r ){
+    uint8_t k;
+
+    if( bas == 10u ){
+        if( len <= 5u && x < 0x10000ul )
+            n2s_Dec16( s, (uint16_t)x, len );
+        else
+            n2s_Dec( s, x, len );
+        return;
+    }
+    k = n2s_Shift( bas );
+    if( k == 4u )
+        n2s_Hex( s, x, len );
+    else if( k )
+        n2s_Pow2( s, x, k, len );
+    else
+        n2s_Radix( s, r, len );
+}
+
+/**
+ * Put the digits of x on base bas
+ **/
+static void n2s_Unsigned( n2s_t *s, uint32_t x, uint8_t bas ){
+    n2s_radix_t r;
+
+    n2s_Digits( s, x, bas, n2s_Len( x, bas, &r ), &r );
+}
+
+/**
+ * Put the sign (if negative) and the digits of x on base bas
+ **/
+static void n2s_Signed( n2s_t *s, int32_t x, uint8_t bas ){
+    uint32_t m = (uint32_t)x;
+
     if( x < 0 ){
-        *(p++) = '-';
-        x *= -1;
-        xx++;
+        n2s_Put( s, '-' );
+        m = 0u - m;     // magnitude, valid for INT32_MIN too
     }
-    
-    //*p = '\0';
-    
-    do{
-        *(--p) = (uint8_t)(x%bas) + '0';
-        x /= bas;
-        xx++;
-    }while( x );
-    
-    return (uint8_t)xx;
+    n2s_Unsigned( s, m, bas );
 }
 
+/**
+ * Put the sign (if neg) and the digits of m on base bas, with a decimal point
+ * before the last 'decimals' digits, on a field of 'width' characters
+ * aligned and padded as specified by width/pad (see num2str.h).
+ * width = 0: no field, natural size.
+ **/
+static void n2s_Field( n2s_t *s, uint32_t m, uint8_t neg, uint8_t bas,
+                       uint8_t decimals, uint8_t width, char pad ){
+    uint8_t left = width & NUM2STR_ALIGN_LEFT;
+    uint8_t len, size, fill = 0u;
+    n2s_radix_t r;
 
-uint8_t ushort2str( uint8_t x, uint8_t bas, char *p ){
-    
-    uint8_t xx = x;
-    
-    do{
-        p++;
-        xx /= bas;
-    }while( xx );
+    width &= (uint8_t)~NUM2STR_ALIGN_LEFT;
+    len = n2s_Len( m, bas, &r );
+    if( m == 0u )                           // do not print "-0.00"
+        neg = 0u;
+    if( decimals ){
+        if( len <= decimals )               // leading zeros: 0.0x
+            len = decimals + 1u;
+        s->point = len - decimals;
+    }
+    size = len + neg + (decimals ? 1u : 0u);
 
-    //*p = '\0';
-    
-    do{
-        *(--p) = (uint8_t)(x%bas) + '0';
-        x /= bas;
-        xx++;
-    }while( x );
-    
-    return xx;
-}
-
-uint8_t uint2str( uint16_t x, uint8_t bas, char *p ){
-    
-    uint16_t xx = x;
-    
-    do{
-        p++;
-        xx /= bas;
-    }while( xx );
-  
-    //*p = '\0';
-    
-    do{
-        *(--p) = x%bas + '0';
-        x /= bas;
-        xx++;
-    }while( x );
-    
-    return xx;
-}
-
-uint8_t ulong2str( uint32_t x, uint8_t bas, char *p ){
-    
-    uint32_t xx = x;
-    
-    do{
-        p++;
-        xx /= bas;
-    }while( xx );
-     
-    //*p = '\0';
-    
-    do{
-        *(--p) = x%bas + '0';
-        x /= bas;
-        xx++;
-    }while( x );
-    
-    return xx;
+    if( width ){
+        if( size > width ){                 // does not fit
+            while( width ){
+                n2s_Put( s, NUM2STR_OVERFLOW_CHAR );
+                width--;
+            }
+            return;
+        }
+        fill = width - size;
+    }
+
+    if( left )
+        pad = ' ';
+    else if( pad != '0' ){                  // spaces before the sign
+        while( fill ){
+            n2s_Put( s, pad );
+            fill--;
+        }
+    }
+    if( neg )
+        n2s_Put( s, '-' );
+    if( !left ){                            // zeros after the sign
+        while( fill ){
+            n2s_Put( s, '0' );
+            fill--;
+        }
+    }
+    n2s_Digits( s, m, bas, len, &r );
+    while( fill ){                          // left aligned
+        n2s_Put( s, pad );
+        fill--;
+    }
+}
+
+/**
+ * Put the signed x on a field (see n2s_Field)
+ **/
+static void n2s_SignedField( n2s_t *s, int32_t x, uint8_t bas,
+                             uint8_t decimals, uint8_t width, char pad ){
+    uint32_t m = (uint32_t)x;
+
+    if( x < 0 )
+        m = 0u - m;
+    n2s_Field( s, m, x < 0, bas, decimals, width, pad );
+}
+
+/******************************************************************************
+ ************************* Section: num2str APIs ******************************
+ ******************************************************************************/
+
+uint8_t short2str( int8_t x, uint8_t bas, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Signed( &s, x, bas );
+    return n2s_End( &s );
+}
+
+uint8_t int2str( int16_t x, uint8_t bas, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Signed( &s, x, bas );
+    return n2s_End( &s );
+}
+
+uint8_t long2str( int32_t x, uint8_t bas, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Signed( &s, x, bas );
+    return n2s_End( &s );
+}
+
+
+uint8_t (ushort2str)( uint8_t x, uint8_t bas, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Unsigned( &s, x, bas );
+    return n2s_End( &s );
+}
+
+uint8_t (uint2str)( uint16_t x, uint8_t bas, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Unsigned( &s, x, bas );
+    return n2s_End( &s );
+}
+
+uint8_t (ulong2str)( uint32_t x, uint8_t bas, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Unsigned( &s, x, bas );
+    return n2s_End( &s );
+}
+
+uint8_t ushort2str_w( uint8_t x, uint8_t bas, uint8_t width, char pad, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Field( &s, x, 0u, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t uint2str_w( uint16_t x, uint8_t bas, uint8_t width, char pad, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Field( &s, x, 0u, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t ulong2str_w( uint32_t x, uint8_t bas, uint8_t width, char pad, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Field( &s, x, 0u, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t short2str_w( int8_t x, uint8_t bas, uint8_t width, char pad, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_SignedField( &s, x, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t int2str_w( int16_t x, uint8_t bas, uint8_t width, char pad, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_SignedField( &s, x, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t long2str_w( int32_t x, uint8_t bas, uint8_t width, char pad, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_SignedField( &s, x, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t ulong2hex( uint32_t x, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Hex( &s, x, n2s_Pow2Len( x, 4u ) );
+    return n2s_End( &s );
+}
+
+uint8_t ulong2oct( uint32_t x, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Pow2( &s, x, 3u, n2s_Pow2Len( x, 3u ) );
+    return n2s_End( &s );
+}
+
+uint8_t ulong2bin( uint32_t x, char *p ){
+    n2s_t s;
+
+    n2s_Begin( &s, p );
+    n2s_Pow2( &s, x, 1u, n2s_Pow2Len( x, 1u ) );
+    return n2s_End( &s );
+}
+
+uint8_t fix2str( int32_t x, uint8_t decimals, char *p ){
+    n2s_t s;
+
+    if( decimals > 9u )
+        decimals = 9u;
+    n2s_Begin( &s, p );
+    n2s_SignedField( &s, x, 10u, decimals, 0u, ' ' );
+    return n2s_End( &s );
+}
+
+uint8_t q8_8_2str( int16_t x, uint8_t afterpoint, char *p ){
+    uint16_t m = (uint16_t)x;
+    uint8_t ip;
+    uint32_t frac, pw;
+    n2s_t s;
+
+    if( x < 0 )
+        m = 0u - m;
+    if( afterpoint > NUM2STR_FIX_MAX_DECIMALS )
+        afterpoint = NUM2STR_FIX_MAX_DECIMALS;
+
+    pw = n2s_pow10[9u - afterpoint];
+    ip = BYTE_GetByte8to16( m );
+    // round to nearest: (f * 10^n + 0.5) / 256, carry goes to ip
+    frac = ((uint32_t)BYTE_GetByte0to8( m ) * pw + 0x80u) >> 8;
+
+    n2s_Begin( &s, p );
+    n2s_Field( &s, ip * pw + frac, x < 0, 10u, afterpoint, 0u, ' ' );
+    return n2s_End( &s );
+}
+
+uint8_t q16_16_2str( int32_t x, uint8_t afterpoint, char *p ){
+    uint32_t m = (uint32_t)x;
+    uint16_t ip;
+    uint32_t frac, pw;
+    n2s_t s;
+
+    if( x < 0 )
+        m = 0u - m;
+    if( afterpoint > NUM2STR_FIX_MAX_DECIMALS )
+        afterpoint = NUM2STR_FIX_MAX_DECIMALS;
+
+    pw = n2s_pow10[9u - afterpoint];
+    ip = (uint16_t)(m >> 16);
+    // round to nearest: (f * 10^n + 0.5) / 65536, carry goes to ip
+    // (ip <= 32768, so ip * 10^4 + frac fits on 32 bits)
+    frac = ((uint32_t)(uint16_t)m * pw + 0x8000u) >> 16;
+
+    n2s_Begin( &s, p );
+    n2s_Field( &s, ip * pw + frac, x < 0, 10u, afterpoint, 0u, ' ' );
+    return n2s_End( &s );
 }
 
 uint8_t float2str( float x, uint8_t afterpoint, char *p ){
-    int ipart = (int)x; // integer part
-    uint8_t sz = 0;
-    float fpart = x - (float)ipart; // float part
-    sz = int2str( ipart, 10, p );
-    
-    if( afterpoint != 0 ){
-        p[sz++] = '.';
-        for( uint8_t i = 0; i < afterpoint; i++ )
-            fpart *= 10;
-        sz += int2str( (int16_t)fpart, 10, p+sz );
-    }
-    return sz;
-}
\ No newline at end of file
+    float s;
+
+    if( afterpoint > 9u )
+        afterpoint = 9u;
+    // scale once and round to nearest, the digits are printed by fix2str.
+    // The cast to int32_t is undefined out of its range: drop decimals until
+    // the scaled value fits (NaN never fits)
+    for( ;; ){
+        s = x * (float)n2s_pow10[9u - afterpoint];
+        s = (s < 0) ? s - 0.5f : s + 0.5f;
+        if( s > -2147483648.0f && s < 2147483648.0f )
+            break;
+        if( afterpoint == 0u ){
+            *p = NUM2STR_OVERFLOW_CHAR;
+            return 1u;
+        }
+        afterpoint--;
+    }
+    return fix2str( (int32_t)s, afterpoint, p );
+}
+
+/******************************************************************************
+ ************************** Section: Sink APIs ********************************
+ ******************************************************************************/
+
+uint8_t ulong2sink( uint32_t x, uint8_t bas, uint8_t width, char pad, const num2str_sink_t *sink ){
+    n2s_t s;
+
+    n2s_BeginSink( &s, sink );
+    n2s_Field( &s, x, 0u, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t long2sink( int32_t x, uint8_t bas, uint8_t width, char pad, const num2str_sink_t *sink ){
+    n2s_t s;
+
+    n2s_BeginSink( &s, sink );
+    n2s_SignedField( &s, x, bas, 0u, width, pad );
+    return n2s_End( &s );
+}
+
+uint8_t fix2sink( int32_t x, uint8_t decimals, uint8_t width, char pad, const num2str_sink_t *sink ){
+    n2s_t s;
+
+    if( decimals > 9u )
+        decimals = 9u;
+    n2s_BeginSink( &s, sink );
+    n2s_SignedField( &s, x, 10u, decimals, width, pad );
+    return n2s_End( &s );
+}
+
+void NUM2STR_BufferPut( void *ctx, char c ){
+    char **cursor = (char**)ctx;
+    *(*cursor)++ = c;
+}
+
+/******************************************************************************
+ ************************* Section: str2num APIs ******************************
+ ******************************************************************************/
+
+void STR2NUM_Initialize( str2num_t *p, uint8_t flags, uint32_t max ){
+    p->value = 0u;
+    p->max = max;
+    if( flags & STR2NUM_SIGNED )
+        p->max++;               // limit of the negative numbers
+    p->flags = flags & (STR2NUM_HEX | STR2NUM_SIGNED);
+    p->count = 0u;
+    p->state = STR2NUM_BUSY;
+}
+
+uint8_t STR2NUM_Put( str2num_t *p, char c ){
+    uint32_t v = p->value;
+    uint8_t d = (uint8_t)c - (uint8_t)'0';
+
+    if( p->state != STR2NUM_BUSY )
+        return p->state;
+
+    if( p->count == 0u && (p->flags & STR2NUM_SIGNED) &&
+        ( c == '-' || c == '+' ) ){         // sign, decimal or hexadecimal
+        if( c == '-' )
+            p->flags |= STR2NUM_NEG;
+        p->count++;
+        return STR2NUM_BUSY;
+    }
+
+    if( p->flags & STR2NUM_HEX ){
+        if( d >= 10u ){
+            d = ((uint8_t)c | 0x20u) - (uint8_t)'a';   // lower case
+            if( d >= 6u )
+                goto end;
+            d += 10u;
+        }
+        if( (uint8_t)(v >> 28) )
+            goto error;
+        v <<= 4;
+    }
+    else{
+        if( d >= 10u )
+            goto end;
+        if( v > 429496729ul )               // v * 10 does not fit
+            goto error;
+        v = (v << 3) + (v << 1);
+    }
+
+    v += d;
+    if( v < d || v > p->max )               // wrap around or above the limit
+        goto error;
+    if( p->count == 0xFFu )                 // the count does not fit
+        goto error;
+    p->value = v;
+    p->flags |= STR2NUM_DIGITS;
+    p->count++;
+    return STR2NUM_BUSY;
+
+end:
+    if( !(p->flags & STR2NUM_DIGITS) )
+        goto error;
+    if( (p->flags & (STR2NUM_SIGNED | STR2NUM_NEG)) == STR2NUM_SIGNED &&
+        v == p->max )                       // positive limit is max - 1
+        goto error;
+    p->state = STR2NUM_DONE;
+    return STR2NUM_DONE;
+
+error:
+    p->state = STR2NUM_ERROR;
+    return STR2NUM_ERROR;
+}
+
+/**
+ * Feed the string s to the parser p. Return the characters consumed, or 0
+ * on error
+ **/
+static uint8_t s2n_Parse( str2num_t *p, const char *s ){
+    while( STR2NUM_Put( p, *s ) == STR2NUM_BUSY )
+        s++;
+    return (p->state == STR2NUM_DONE) ? p->count : 0u;
+}
+
+uint8_t str2uint( const char *s, uint16_t *x ){
+    str2num_t p;
+    uint8_t n;
+
+    STR2NUM_Initialize( &p, 0u, 0xFFFFu );
+    n = s2n_Parse( &p, s );
+    if( n )
+        *x = (uint16_t)p.value;
+    return n;
+}
+
+uint8_t str2int( const char *s, int16_t *x ){
+    str2num_t p;
+    uint8_t n;
+
+    STR2NUM_Initialize( &p, STR2NUM_SIGNED, 0x7FFFu );
+    n = s2n_Parse( &p, s );
+    if( n ){
+        uint16_t m = (uint16_t)p.value;
+        if( p.flags & STR2NUM_NEG )
+            m = 0u - m;
+        *x = (int16_t)m;
+    }
+    return n;
+}
+
+uint8_t str2ulong( const char *s, uint32_t *x ){
+    str2num_t p;
+    uint8_t n;
+
+    STR2NUM_Initialize( &p, 0u, 0xFFFFFFFFul );
+    n = s2n_Parse( &p, s );
+    if( n )
+        *x = p.value;
+    return n;
+}
+
+uint8_t hex2uint( const char *s, uint16_t *x ){
+    str2num_t p;
+    uint8_t n;
+
+    STR2NUM_Initialize( &p, STR2NUM_HEX, 0xFFFFu );
+    n = s2n_Parse( &p, s );
+    if( n )
+        *x = (uint16_t)p.value;
+    return n;
+}
@@ -5,6 +5,10 @@
  * @Description:
  * This header contain a set of routines prototypes for store numbers on 
  * string.
+ *  Every routine write the characters starting on 'res' (the string is not
+ * null terminated) and return the number of characters written.
+ *  Supported bases are in range [2-16]. The conversion does not use the
+ * division helpers of the compiler (see num2str.c).
  */
 
 #ifndef NUM2STR_H
@@ -12,6 +16,137 @@
 
 #include <stdint.h>
 
+/**
+ * NUM2STR_CONSTANT_BASE_DISPATCH
+ *
+ * @Description
+ *  When 1, ushort2str/uint2str/ulong2str are also defined as macros that call
+ * ulong2hex, ulong2oct or ulong2bin directly when the base is 16, 8 or 2.
+ * With a constant base the compiler removes the comparisons, with a variable
+ * base they are evaluated on every call (and 'bas' is evaluated several times).
+ *  Set to 0 (-DNUM2STR_CONSTANT_BASE_DISPATCH=0) to always call the
+ * functions.
+ **/
+#ifndef NUM2STR_CONSTANT_BASE_DISPATCH
+#define NUM2STR_CONSTANT_BASE_DISPATCH 1
+#endif
+
+/**
+ * NUM2STR_DEC_PAIRS
+ *
+ * @Description
+ *  When 1, decimal numbers are converted two digits at time: every pair
+ * (00-99) is found with 7 binary weighted subtractions and its characters
+ * are read from a 200 bytes const table. When 0, one digit at time with up
+ * to 9 subtractions per digit (smaller).
+ *  The pairs only lower the worst case, the average is a bit higher (make -C
+ * test bench, subtractions per conversion avg/max):
+ *  - uint2str, every 16 bits value: 16.1/32 with 0, 16.8/20 with 1
+ *  - ulong2str, uniform 32 bits values: 37.4/70 with 0, 37.9/61 with 1
+ *  Set it to 1 only when the time of the slowest conversion matters (Ej: a
+ * conversion on a fixed time slot) and the table fits on program memory.
+ *  Default: 0
+ **/
+#ifndef NUM2STR_DEC_PAIRS
+#define NUM2STR_DEC_PAIRS 0
+#endif
+
+/**
+ * NUM2STR_STATS
+ *
+ * @Description
+ *  When 1, the conversion engine counts its basic operations on num2str_stats
+ * (subtract steps, division steps, shift steps and characters put). It is
+ * used for compare implementations on a host build (see README), keep it at
+ * 0 on the target.
+ **/
+#ifndef NUM2STR_STATS
+#define NUM2STR_STATS 0
+#endif
+
+/**
+ * Maximum amount of decimals printed by q8_8_2str and q16_16_2str
+ **/
+#define NUM2STR_FIX_MAX_DECIMALS 4u
+
+/**
+ * Flag for the 'width' argument of the *2str_w routines: align the number
+ * to the left side of the field (filled with spaces).
+ **/
+#define NUM2STR_ALIGN_LEFT 0x80u
+
+/**
+ * Character used to fill a field when the number does not fit on it
+ **/
+#define NUM2STR_OVERFLOW_CHAR '#'
+
+/**
+ * Character sink: every character is sent with Put( ctx, c ) as soon as it
+ * is produced (most significant digit first), no intermediate buffer is used.
+ *  Drivers export their own sinks (Ej: LCD_Sink, LedDisplay_Sink).
+ *  Put runs on the context of the caller. The conversion routines keep
+ * their state on the stack, so they can be called from the ISR, but a sink
+ * is only as reentrant as its Put routine: NUM2STR_BufferPut with a ctx per
+ * call is, the display sinks (they write the display state) must not be
+ * used from the main code and from the ISR.
+ *
+ * @Example
+ * <code>
+ *  char buf[11], *cursor = buf;
+ *  const num2str_sink_t ramSink = { NUM2STR_BufferPut, &cursor };
+ *
+ *  ulong2sink( 1234, 10, 6, '0', &ramSink );   // "001234"
+ *  long2sink( -5, 10, 0, ' ', &LCD_Sink );     // "-5" on the LCD
+ * </code>
+ **/
+typedef struct{
+    void (*Put)( void *ctx, char c );
+    void *ctx;
+} num2str_sink_t;
+
+/**
+ * Parser state for the streaming string to number conversion (see
+ * STR2NUM_Put). Every object is independent, so several inputs (Ej: one
+ * per ISR receive path) can be parsed at the same time.
+ **/
+typedef struct{
+    uint32_t value;     // magnitude parsed so far
+    uint32_t max;       // maximum magnitude
+    uint8_t flags;      // STR2NUM_HEX | STR2NUM_SIGNED | internal flags
+    uint8_t count;      // characters consumed (255 at most)
+    uint8_t state;      // STR2NUM_BUSY, STR2NUM_DONE or STR2NUM_ERROR
+} str2num_t;
+
+/**
+ * STR2NUM_Initialize flags
+ **/
+#define STR2NUM_HEX     0x01u   // hexadecimal digits (0-9, A-F, a-f)
+#define STR2NUM_SIGNED  0x02u   // accept a leading '-' or '+' (also on hex)
+#define STR2NUM_NEG     0x04u   // (read only) a '-' was received
+#define STR2NUM_DIGITS  0x08u   // (read only) at least one digit received
+
+/**
+ * STR2NUM_Put return values
+ **/
+#define STR2NUM_BUSY    0u      // character consumed, the number continues
+#define STR2NUM_DONE    1u      // number finished (character not consumed)
+#define STR2NUM_ERROR   2u      // no digits or overflow
+
+#if NUM2STR_STATS == 1
+/**
+ * Operation counters (see NUM2STR_STATS). Clear them before a call and read
+ * them after it.
+ **/
+typedef struct{
+    uint32_t subtract;  // compare-and-subtract steps (digit extraction)
+    uint32_t divide;    // shift-and-subtract division steps (1 per bit)
+    uint32_t shift;     // bit/nibble shift steps (power of two bases)
+    uint32_t put;       // characters put
+} num2str_stats_t;
+
+extern num2str_stats_t num2str_stats;
+#endif
+
 #ifdef	__cplusplus
 extern "C" {
 #endif
@@ -25,6 +160,102 @@ extern "C" {
     uint8_t long2str( int32_t x, uint8_t bas, char *res );
     
     uint8_t float2str( float x, uint8_t afterpoint, char *res );
+
+    /* Fixed point numbers, printed with integer arithmetic only.
+     *  - fix2str:     x * 10^-decimals, all the decimals are printed.
+     *                 Ej: fix2str( -105, 2, res ) -> "-1.05"
+     *  - q8_8_2str:   Q8.8 number (x / 256), rounded to 'afterpoint' decimals
+     *  - q16_16_2str: Q16.16 number (x / 65536), rounded to 'afterpoint' decimals
+     * float2str scales x by 10^afterpoint once and use fix2str. When
+     * x * 10^afterpoint does not fit on 31 bits less decimals are printed
+     * (Ej: float2str( 100000.0f, 5, res ) -> "100000.0000"), and a value that
+     * does not fit without decimals (|x| >= 2^31, NaN) is printed as one
+     * NUM2STR_OVERFLOW_CHAR. New code should use the fixed point routines. */
+    uint8_t fix2str( int32_t x, uint8_t decimals, char *res );
+    uint8_t q8_8_2str( int16_t x, uint8_t afterpoint, char *res );
+    uint8_t q16_16_2str( int32_t x, uint8_t afterpoint, char *res );
+
+    /* Field routines: always write exactly 'width' characters (1 to 127), so
+     * a value can be overwritten in place on a display without clear it.
+     * Width 0 means no field (natural size).
+     *  - Right aligned (default): filled with 'pad' on the left. With pad '0'
+     *    the zeros are put after the sign ("-0042").
+     *  - Left aligned (width | NUM2STR_ALIGN_LEFT): filled with spaces.
+     *  - If the number does not fit, the field is filled with
+     *    NUM2STR_OVERFLOW_CHAR.
+     * Ej: uint2str_w( 99, 10, 3, ' ', res ) -> " 99" */
+    uint8_t ushort2str_w( uint8_t x, uint8_t bas, uint8_t width, char pad, char *res );
+    uint8_t uint2str_w( uint16_t x, uint8_t bas, uint8_t width, char pad, char *res );
+    uint8_t ulong2str_w( uint32_t x, uint8_t bas, uint8_t width, char pad, char *res );
+
+    uint8_t short2str_w( int8_t x, uint8_t bas, uint8_t width, char pad, char *res );
+    uint8_t int2str_w( int16_t x, uint8_t bas, uint8_t width, char pad, char *res );
+    uint8_t long2str_w( int32_t x, uint8_t bas, uint8_t width, char pad, char *res );
+
+    /* Power of two bases, digits extracted with shifts and masks only */
+    uint8_t ulong2hex( uint32_t x, char *res );
+    uint8_t ulong2oct( uint32_t x, char *res );
+    uint8_t ulong2bin( uint32_t x, char *res );
+
+    /* Sink routines: same conversions, but the characters are sent to 'sink'
+     * instead of stored. 'width' and 'pad' work as on the field routines
+     * (width 0: natural size). Return the number of characters sent.
+     * Ej: fix2sink( -105, 2, 6, ' ', &LCD_Sink ) -> " -1.05" */
+    uint8_t ulong2sink( uint32_t x, uint8_t bas, uint8_t width, char pad, const num2str_sink_t *sink );
+    uint8_t long2sink( int32_t x, uint8_t bas, uint8_t width, char pad, const num2str_sink_t *sink );
+    uint8_t fix2sink( int32_t x, uint8_t decimals, uint8_t width, char pad, const num2str_sink_t *sink );
+
+    /* Sink routine for RAM buffers: ctx is a char** with the next position,
+     * it is advanced on every character (the buffer is not null terminated) */
+    void NUM2STR_BufferPut( void *ctx, char c );
+
+    /* String to number: parse the digits at the start of 's' and stop on the
+     * first non digit character (no division is used). On success store the
+     * value on *x and return the amount of characters consumed; return 0 (and
+     * *x is not modified) if there are no digits, the value overflows or the
+     * number is longer than 255 characters.
+     *  - str2int accepts a leading '-' or '+'.
+     *  - hex2uint accepts the digits 0-9, A-F and a-f (no "0x" prefix).
+     * Ej: str2uint( "1250,3", &x ) -> 4, x = 1250 */
+    uint8_t str2uint( const char *s, uint16_t *x );
+    uint8_t str2int( const char *s, int16_t *x );
+    uint8_t str2ulong( const char *s, uint32_t *x );
+    uint8_t hex2uint( const char *s, uint16_t *x );
+
+    /**
+     * Prepare p for parse a number of magnitude <= max (signed numbers: the
+     * positive limit, -(max+1) is accepted, max < 2^31) with the STR2NUM_xxx
+     * flags.
+     **/
+    void STR2NUM_Initialize( str2num_t *p, uint8_t flags, uint32_t max );
+
+    /**
+     * Feed one character to the parser (Ej: from the receive ISR). Return:
+     *  - STR2NUM_BUSY:  c was consumed, feed the next character.
+     *  - STR2NUM_DONE:  c is not part of the number (not consumed), the
+     *                   number is on p->value (negative if p->flags has
+     *                   STR2NUM_NEG).
+     *  - STR2NUM_ERROR: no digits before c, overflow, or more than 255
+     *                   characters (the count does not fit, leading zeros
+     *                   included).
+     * After DONE or ERROR the state does not change until the next
+     * STR2NUM_Initialize.
+     **/
+    uint8_t STR2NUM_Put( str2num_t *p, char c );
+
+#if NUM2STR_CONSTANT_BASE_DISPATCH == 1
+
+#define NUM2STR_DISPATCH( f, x, bas, res )                  \
+        ( (bas) == 16u ? ulong2hex( (x), (res) ) :          \
+          (bas) == 8u  ? ulong2oct( (x), (res) ) :          \
+          (bas) == 2u  ? ulong2bin( (x), (res) ) :          \
+                         (f)( (x), (bas), (res) ) )
+
+#define ushort2str( x, bas, res )   NUM2STR_DISPATCH( ushort2str, x, bas, res )
+#define uint2str( x, bas, res )     NUM2STR_DISPATCH( uint2str, x, bas, res )
+#define ulong2str( x, bas, res )    NUM2STR_DISPATCH( ulong2str, x, bas, res )
+
+#endif
         
     
     
@@ -0,0 +1,99 @@
+/*
+ * File:   profile.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the Timer1 execution time probes (see profile.h).
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include "profile.h"
+#include "critical.h"
+
+/******************************************************************************
+ ************************** Section: Global Vars ******************************
+ ******************************************************************************/
+
+#if PROFILE_ENABLE
+profile_probe_t profile_probes[PROFILE_PROBES];
+#endif
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+#if PROFILE_ENABLE
+static uint16_t profile_overhead;       // counts of an empty probe
+#endif
+
+/******************************************************************************
+ ************************ Section: Profile APIs *******************************
+ ******************************************************************************/
+
+uint16_t PROFILE_Now( void ){
+    uint8_t high, low;
+
+    // TMR1L can overflow between the two bytes reads
+    do{
+        high = TMR1H;
+        low = TMR1L;
+    }while( high != TMR1H );
+    return ((uint16_t)high << 8) | low;
+}
+
+#if PROFILE_ENABLE
+
+void PROFILE_Initialize( void ){
+    T1CON = 0x01;                       // TMR1ON, Fosc/4, 1:1
+    profile_overhead = 0u;
+
+    // the empty probe is measured on PROFILE_ID_USER
+    PROFILE_Begin( PROFILE_ID_USER );
+    PROFILE_End( PROFILE_ID_USER );
+    profile_overhead = profile_probes[PROFILE_ID_USER].max;
+
+    PROFILE_Clear();
+}
+
+void PROFILE_Clear( void ){
+    uint8_t i;
+
+    for( i = 0; i < PROFILE_PROBES; i++ ){
+        CRITICAL_ENTER();
+        profile_probes[i].count = 0u;
+        profile_probes[i].min = 0xFFFFu;
+        profile_probes[i].max = 0u;
+        profile_probes[i].total = 0u;
+        CRITICAL_EXIT();
+    }
+}
+
+void PROFILE_Begin( uint8_t id ){
+    profile_probes[id].start = PROFILE_Now();
+}
+
+void PROFILE_End( uint8_t id ){
+    PROFILE_Record( id, profile_probes[id].start );
+}
+
+void PROFILE_Record( uint8_t id, uint16_t start ){
+    uint16_t t = PROFILE_Now() - start;
+    profile_probe_t *p = &profile_probes[id];
+
+    t = (t > profile_overhead) ? t - profile_overhead : 0u;
+
+    // an ISR probe can not see the record half updated
+    CRITICAL_ENTER();
+    if( p->count != 0xFFFFu ){
+        p->count++;
+        p->total += t;
+        if( t < p->min )
+            p->min = t;
+        if( t > p->max )
+            p->max = t;
+    }
+    CRITICAL_EXIT();
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * File:   profile.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Execution time probes on a free running Timer1. Every probe keeps the
+ * call count and the min/max/total Timer1 counts between PROFILE_BEGIN and
+ * PROFILE_END (instruction cycles with the default Fosc/4 clock and 1:1
+ * prescaler), without the cost of the probe itself.
+ *  With PROFILE_ENABLE = 0 (default) the macros expand to nothing and no
+ * code or RAM is used.
+ *  - A measure must be shorter than 65536 counts (13ms at 20MHz), for
+ *    longer code set a Timer1 prescaler after PROFILE_Initialize.
+ *  - A PROFILE_BEGIN / PROFILE_END probe can not be nested with itself, and
+ *    must not be used from the main code and from the ISR at the same time
+ *    (the start time is kept on the probe record).
+ *  - PROFILE_START / PROFILE_STOP keep the start time on a variable of the
+ *    caller (Ej: a local), so the same probe can be used from reentrant code
+ *    (main and ISR, or nested): every measure is recorded on its own.
+ *
+ *  The library has probes on its hot paths (PROFILE_ID_xxx below), the
+ * application can use the ids from PROFILE_ID_USER.
+ *
+ * @Example
+ * <code>
+ *  PROFILE_Initialize();
+ *  ...
+ *  PROFILE_BEGIN( PROFILE_ID_USER );
+ *  control();
+ *  PROFILE_END( PROFILE_ID_USER );
+ *  ...
+ *  // profile_probes[PROFILE_ID_USER].max: worst time of control()
+ * </code>
+ */
+
+#ifndef PROFILE_H
+#define	PROFILE_H
+
+#include <stdint.h>
+
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE      0
+#endif
+
+/**
+ * Probes for the application (ids PROFILE_ID_USER, PROFILE_ID_USER + 1, ...)
+ **/
+#ifndef PROFILE_USER_PROBES
+#define PROFILE_USER_PROBES 2u
+#endif
+
+/**
+ * Probes ids
+ **/
+enum{
+    PROFILE_ID_NUM2STR = 0,         // num2str conversions (*2str, *2sink)
+    PROFILE_ID_LCD_DATA_WRITE,      // lcd_DataWrite (one character)
+    PROFILE_ID_LED_DISPLAY_LOAD,    // LedDisplay_LoadDotRegister
+    PROFILE_ID_ADC_CONVERSION,      // ADC_GetConversion
+    PROFILE_ID_EEPROM_WRITE,        // EEPROM_WriteByte
+    PROFILE_ID_MCP4922_WRITE,       // MCP4922_WriteData
+    PROFILE_ID_SPI_BLOCK,           // SPI_Transfer, SPI_WriteBlock, SPI_ReadBlock
+    PROFILE_ID_USER,
+    PROFILE_PROBES = PROFILE_ID_USER + PROFILE_USER_PROBES
+};
+
+#if PROFILE_ENABLE
+
+/**
+ * Probe record
+ **/
+typedef struct{
+    uint16_t start;         // Timer1 at PROFILE_BEGIN
+    uint16_t count;         // measures (saturate at 65535)
+    uint16_t min;
+    uint16_t max;
+    uint32_t total;         // sum of the measures (for the average)
+} profile_probe_t;
+
+extern profile_probe_t profile_probes[PROFILE_PROBES];
+
+#define PROFILE_BEGIN( id )     PROFILE_Begin( id )
+#define PROFILE_END( id )       PROFILE_End( id )
+
+/**
+ * Measure with the start time on 't' (uint16_t, declared with
+ * PROFILE_START_VAR so it is not compiled when the probes are disabled)
+ **/
+#define PROFILE_START_VAR( t )  uint16_t t;
+#define PROFILE_START( t )      ( (t) = PROFILE_Now() )
+#define PROFILE_STOP( id, t )   PROFILE_Record( id, t )
+
+#else
+
+#define PROFILE_BEGIN( id )     ((void)0)
+#define PROFILE_END( id )       ((void)0)
+
+#define PROFILE_START_VAR( t )
+#define PROFILE_START( t )      ((void)0)
+#define PROFILE_STOP( id, t )   ((void)0)
+
+#endif
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    /**
+     * Timer1 value. Used as time base by the probes, the ISR statistics and
+     * the critical sections instrumentation.
+     **/
+    uint16_t PROFILE_Now( void );
+
+#if PROFILE_ENABLE
+    /**
+     * Start Timer1 (Fosc/4, prescaler 1:1), clear the probes and measure the
+     * cost of an empty probe
+     **/
+    void PROFILE_Initialize( void );
+
+    /**
+     * Clear the records of all the probes
+     **/
+    void PROFILE_Clear( void );
+
+    /**
+     * Start / end a measure (use the PROFILE_BEGIN / PROFILE_END macros)
+     **/
+    void PROFILE_Begin( uint8_t id );
+    void PROFILE_End( uint8_t id );
+
+    /**
+     * Record a measure started at 'start' (PROFILE_Now) on the probe id
+     * (use the PROFILE_START / PROFILE_STOP macros). Safe from the ISR.
+     **/
+    void PROFILE_Record( uint8_t id, uint16_t start );
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PROFILE_H */
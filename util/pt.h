@@ -0,0 +1,97 @@
+/*
+ * File:   pt.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Protothreads: resumable routines without own stack. A task is a routine
+ * that receive a pt_t and return one of the PT_xxx states; when it must wait
+ * it returns, and the next call continues after the wait point.
+ *  The resume point is stored as a line number (switch/case), so:
+ *  - Local variables are not kept between calls: use static variables or
+ *    fields of a struct for the values that live across a wait.
+ *  - Only one PT_xxx wait macro per source line.
+ *  - A switch statement can not contain a wait point.
+ *
+ * @Example
+ * <code>
+ *  uint8_t blink( pt_t *pt ){
+ *      PT_BEGIN( pt );
+ *      while( 1 ){
+ *          LED = !LED;
+ *          SCHED_DELAY_MS( pt, 500u );     // see sched.h
+ *      }
+ *      PT_END( pt );
+ *  }
+ * </code>
+ */
+
+#ifndef PT_H
+#define	PT_H
+
+#include <stdint.h>
+
+/**
+ * Task states
+ **/
+#define PT_WAITING  0u      // waiting for a condition
+#define PT_YIELDED  1u      // gave the CPU, call again
+#define PT_EXITED   2u      // finished with PT_EXIT
+#define PT_ENDED    3u      // reached PT_END
+
+/**
+ * Protothread control block
+ **/
+typedef struct{
+    uint16_t lc;            // resume point (0: start)
+    uint16_t t;             // start time of the current delay (see sched.h)
+} pt_t;
+
+#define PT_INIT( pt )       do{ (pt)->lc = 0u; }while(0)
+
+#define PT_BEGIN( pt )      { uint8_t pt_yield = 1u; (void)pt_yield;        \
+                              switch( (pt)->lc ){ case 0u:
+
+#define PT_END( pt )        } PT_INIT( pt ); return PT_ENDED; }
+
+/**
+ * Return while cond is false / true
+ **/
+#define PT_WAIT_UNTIL( pt, cond )   do{                     \
+            (pt)->lc = __LINE__; case __LINE__:             \
+            if( !(cond) )                                   \
+                return PT_WAITING;                          \
+        }while(0)
+
+#define PT_WAIT_WHILE( pt, cond )   PT_WAIT_UNTIL( (pt), !(cond) )
+
+/**
+ * Give the CPU to the other tasks once
+ **/
+#define PT_YIELD( pt )      do{                             \
+            pt_yield = 0u;                                  \
+            (pt)->lc = __LINE__; case __LINE__:             \
+            if( pt_yield == 0u )                            \
+                return PT_YIELDED;                          \
+        }while(0)
+
+/**
+ * Run the child task 'thread' (a call using child) until it ends
+ **/
+#define PT_WAIT_THREAD( pt, thread )    PT_WAIT_WHILE( (pt), (thread) < PT_EXITED )
+
+#define PT_SPAWN( pt, child, thread )   do{                 \
+            PT_INIT( child );                               \
+            PT_WAIT_THREAD( (pt), (thread) );               \
+        }while(0)
+
+/**
+ * Finish the task (the next call starts again)
+ **/
+#define PT_EXIT( pt )       do{ PT_INIT( pt ); return PT_EXITED; }while(0)
+
+/**
+ * Restart the task from PT_BEGIN on the next call
+ **/
+#define PT_RESTART( pt )    do{ PT_INIT( pt ); return PT_WAITING; }while(0)
+
+#endif	/* PT_H */
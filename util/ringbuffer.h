@@ -0,0 +1,149 @@
+/*
+ * File:   ringbuffer.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Single producer / single consumer ring buffers generated by macro for any
+ * element type and any power of two size (2 to 128 elements).
+ *  The producer only writes 'head' and the consumer only writes 'tail'. Both
+ * are free running 8 bits indexes (a byte access is atomic on the PIC), so
+ * one side can be an ISR and the other the main loop without disabling the
+ * interrupts:
+ *  - Count = head - tail (modulo 256), the buffer is full when Count = size.
+ *  - The element is stored before head is incremented and read before tail
+ *    is incremented.
+ *  Every buffer has its own storage and routines (no pointers to pass, small
+ * code on the PIC). With XC8 a routine called from main and from the ISR is
+ * duplicated, so call every routine from one side only (the SPSC rule).
+ *
+ *  RINGBUFFER_DECLARE( name, type, size ) goes on a header: declare the
+ * routines of buffer 'name'.
+ *  RINGBUFFER_DEFINE( name, type, size ) goes on one source file: create the
+ * storage and the routines:
+ *  - uint8_t name_Push( type x ):      store x. Return 0 if it is full.
+ *  - uint8_t name_Pop( type *x ):      read the oldest element. Return 0 if
+ *                                      it is empty.
+ *  - uint8_t name_Count( void ):       amount of stored elements.
+ *  - uint8_t name_Free( void ):        amount of free places.
+ *  - uint8_t name_PushBlock( const type *src, uint8_t n ): store up to n
+ *      elements, return how many were stored.
+ *  - uint8_t name_PopBlock( type *dst, uint8_t n ): read up to n elements,
+ *      return how many were read.
+ *  - void name_Flush( void ):          drop every element (consumer side).
+ *
+ * @Example
+ * <code>
+ *  // uart_queue.h
+ *  RINGBUFFER_DECLARE( rxQueue, char, 16 )
+ *
+ *  // uart_queue.c
+ *  RINGBUFFER_DEFINE( rxQueue, char, 16 )
+ *
+ *  void __interrupt() isr( void ){
+ *      if( RCIF )
+ *          rxQueue_Push( RCREG );          // producer
+ *  }
+ *
+ *  void main( void ){
+ *      char c;
+ *      ...
+ *      while( rxQueue_Pop( &c ) )          // consumer
+ *          LCD_PrintChar( c );
+ *  }
+ * </code>
+ */
+
+#ifndef RINGBUFFER_H
+#define	RINGBUFFER_H
+
+#include <stdint.h>
+
+/**
+ * Compile time check of the buffer size (power of two, 2 to 128)
+ **/
+#define RINGBUFFER_CHECK_SIZE( name, size )                                 \
+        typedef char name##_size_check[                                     \
+            ( (size) >= 2u && (size) <= 128u &&                             \
+              ((size) & ((size) - 1u)) == 0u ) ? 1 : -1 ]
+
+/**
+ * Declare the routines of the buffer 'name'
+ **/
+#define RINGBUFFER_DECLARE( name, type, size )                              \
+        uint8_t name##_Push( type x );                                      \
+        uint8_t name##_Pop( type *x );                                      \
+        uint8_t name##_Count( void );                                       \
+        uint8_t name##_Free( void );                                        \
+        uint8_t name##_PushBlock( const type *src, uint8_t n );             \
+        uint8_t name##_PopBlock( type *dst, uint8_t n );                    \
+        void name##_Flush( void );
+
+/**
+ * Define the storage and the routines of the buffer 'name'
+ **/
+#define RINGBUFFER_DEFINE( name, type, size )                               \
+        RINGBUFFER_CHECK_SIZE( name, size );                                \
+                                                                            \
+        static type name##_data[size];                                      \
+        static volatile uint8_t name##_head;    /* written by producer */   \
+        static volatile uint8_t name##_tail;    /* written by consumer */   \
+                                                                            \
+        uint8_t name##_Count( void ){                                       \
+            return (uint8_t)(name##_head - name##_tail);                    \
+        }                                                                   \
+                                                                            \
+        uint8_t name##_Free( void ){                                        \
+            return (uint8_t)((size) - (uint8_t)(name##_head - name##_tail));\
+        }                                                                   \
+                                                                            \
+        uint8_t name##_Push( type x ){                                      \
+            uint8_t h = name##_head;                                        \
+            if( (uint8_t)(h - name##_tail) >= (size) )                      \
+                return 0u;                                                  \
+            name##_data[ h & ((size) - 1u) ] = x;                           \
+            name##_head = (uint8_t)(h + 1u);    /* publish */               \
+            return 1u;                                                      \
+        }                                                                   \
+                                                                            \
+        uint8_t name##_Pop( type *x ){                                      \
+            uint8_t t = name##_tail;                                        \
+            if( name##_head == t )                                          \
+                return 0u;                                                  \
+            *x = name##_data[ t & ((size) - 1u) ];                          \
+            name##_tail = (uint8_t)(t + 1u);    /* release */               \
+            return 1u;                                                      \
+        }                                                                   \
+                                                                            \
+        uint8_t name##_PushBlock( const type *src, uint8_t n ){             \
+            uint8_t h = name##_head;                                        \
+            uint8_t free = (uint8_t)((size) - (uint8_t)(h - name##_tail));  \
+            uint8_t i;                                                      \
+            if( n > free )                                                  \
+                n = free;                                                   \
+            for( i = 0u; i < n; i++ ){                                      \
+                name##_data[ h & ((size) - 1u) ] = *src++;                  \
+                h++;                                                        \
+            }                                                               \
+            name##_head = h;                    /* publish all */           \
+            return n;                                                       \
+        }                                                                   \
+                                                                            \
+        uint8_t name##_PopBlock( type *dst, uint8_t n ){                    \
+            uint8_t t = name##_tail;                                        \
+            uint8_t count = (uint8_t)(name##_head - t);                     \
+            uint8_t i;                                                      \
+            if( n > count )                                                 \
+                n = count;                                                  \
+            for( i = 0u; i < n; i++ ){                                      \
+                *dst++ = name##_data[ t & ((size) - 1u) ];                  \
+                t++;                                                        \
+            }                                                               \
+            name##_tail = t;                    /* release all */           \
+            return n;                                                       \
+        }                                                                   \
+                                                                            \
+        void name##_Flush( void ){                                          \
+            name##_tail = name##_head;                                      \
+        }
+
+#endif	/* RINGBUFFER_H */
@@ -0,0 +1,60 @@
+/*
+ * File:   sched.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the cooperative scheduler (see sched.h).
+ */
+
+#include <stdint.h>
+#include "sched.h"
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+static sched_task_t sched_tasks[SCHED_MAX_TASKS];
+static uint8_t sched_count;
+static volatile uint16_t sched_ms;
+
+/******************************************************************************
+ ************************ Section: Scheduler APIs *****************************
+ ******************************************************************************/
+
+void SCHED_Tick( void ){
+    sched_ms++;
+}
+
+uint16_t SCHED_Now( void ){
+    uint16_t t;
+
+    // the ISR can change the counter between the two bytes reads
+    do{
+        t = sched_ms;
+    }while( t != sched_ms );
+    return t;
+}
+
+uint8_t SCHED_Add( sched_task_t task ){
+    if( sched_count >= SCHED_MAX_TASKS )
+        return 0u;
+    sched_tasks[sched_count++] = task;
+    return 1u;
+}
+
+uint8_t SCHED_Run( void ){
+    uint8_t i = 0u;
+
+    while( i < sched_count ){
+        if( sched_tasks[i]() >= PT_EXITED ){
+            // remove the task, keep the order of the others
+            uint8_t j;
+            sched_count--;
+            for( j = i; j < sched_count; j++ )
+                sched_tasks[j] = sched_tasks[j + 1u];
+        }
+        else
+            i++;
+    }
+    return sched_count;
+}
@@ -0,0 +1,88 @@
+/*
+ * File:   sched.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Cooperative scheduler for protothread tasks (see pt.h) and millisecond
+ * time base for non blocking delays.
+ *  Every task is a routine without arguments that returns a PT_xxx state;
+ * SCHED_Run calls all the added tasks once, a task that returns PT_ENDED or
+ * PT_EXITED is removed. SCHED_Tick must be called every 1 ms (Ej: from the
+ * timer ISR), it is the clock of SCHED_DELAY_MS.
+ *
+ * @Example
+ * <code>
+ *  static pt_t ptLcd;
+ *  static uint8_t lcdTask( void ){
+ *      return LCD_InitializeTask( &ptLcd, 2, 16 );
+ *  }
+ *
+ *  void main( void ){
+ *      ...
+ *      SCHED_Add( lcdTask );
+ *      SCHED_Add( controlTask );
+ *      while( 1 )
+ *          SCHED_Run();
+ *  }
+ * </code>
+ */
+
+#ifndef SCHED_H
+#define	SCHED_H
+
+#include <stdint.h>
+#include "pt.h"
+
+/**
+ * Maximum amount of tasks
+ **/
+#define SCHED_MAX_TASKS 4u
+
+/**
+ * Task routine
+ **/
+typedef uint8_t (*sched_task_t)( void );
+
+/**
+ * Milliseconds elapsed since the time 'since' (SCHED_Now value)
+ **/
+#define SCHED_Elapsed( since )  ( (uint16_t)(SCHED_Now() - (since)) )
+
+/**
+ * Wait at least 'ms' milliseconds inside a protothread (ms < 65535)
+ **/
+#define SCHED_DELAY_MS( pt, ms )    do{                         \
+            (pt)->t = SCHED_Now();                              \
+            PT_WAIT_UNTIL( (pt), SCHED_Elapsed( (pt)->t ) > (ms) ); \
+        }while(0)
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    /**
+     * Advance the time base one millisecond. Call it from the timer ISR.
+     **/
+    void SCHED_Tick( void );
+
+    /**
+     * Return the millisecond counter (wraps around every 65536 ms)
+     **/
+    uint16_t SCHED_Now( void );
+
+    /**
+     * Add a task. Return 0 if there are already SCHED_MAX_TASKS tasks.
+     **/
+    uint8_t SCHED_Add( sched_task_t task );
+
+    /**
+     * Call every task once, remove the finished tasks. Return the amount of
+     * tasks still running.
+     **/
+    uint8_t SCHED_Run( void );
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SCHED_H */
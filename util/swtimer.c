@@ -0,0 +1,135 @@
+/*
+ * File:   swtimer.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the software timer wheel (see swtimer.h).
+ *  A timer that expires 'd' ticks after the current slot is linked on slot
+ * (cursor + d) mod SWTIMER_WHEEL_SIZE, it has to wait (d - 1) / SWTIMER_WHEEL_SIZE
+ * turns of the wheel and it expires when the cursor reach its slot with no
+ * turns left.
+ *  Every slot list is sorted by turns, and 'rounds' is the turns after the
+ * previous timer of the list (delta list): a visit of the slot only checks
+ * and decrements the head, the sorted insert is done by SWTIMER_Start.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "swtimer.h"
+
+#define SWTIMER_WHEEL_MASK  (SWTIMER_WHEEL_SIZE - 1u)
+#define SWTIMER_SLOT_EXPIRED 0xFFu          // on the expired list
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+static swtimer_t *swtimer_wheel[SWTIMER_WHEEL_SIZE];
+static swtimer_t *swtimer_expired;          // waiting for the callback call
+static uint8_t swtimer_cursor;              // current slot
+static volatile uint8_t swtimer_ticks;      // ticks counted (written by ISR,
+                                            // 8 bits: atomic read)
+static uint8_t swtimer_done;                // ticks processed (main loop)
+
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+/**
+ * Link t on the wheel to expire 'delay' ticks after the current slot (after
+ * the timers of the slot with the same turns or less)
+ **/
+static void swtimer_Insert( swtimer_t *t, uint16_t delay ){
+    uint8_t slot = (uint8_t)(swtimer_cursor + delay) & SWTIMER_WHEEL_MASK;
+    uint16_t rounds = (uint16_t)(delay - 1u) >> SWTIMER_WHEEL_BITS;
+    swtimer_t **pp = &swtimer_wheel[slot];
+
+    while( *pp != NULL && (*pp)->rounds <= rounds ){
+        rounds -= (*pp)->rounds;
+        pp = &(*pp)->next;
+    }
+    if( *pp != NULL )
+        (*pp)->rounds -= rounds;        // the next one waits after t
+    t->rounds = rounds;
+    t->next = *pp;
+    *pp = t;
+    t->slot = slot;
+    t->active = 1u;
+}
+
+/******************************************************************************
+ ************************* Section: SWTimer APIs ******************************
+ ******************************************************************************/
+
+void SWTIMER_Initialize( swtimer_t *t, void (*callback)( swtimer_t *t ) ){
+    t->callback = callback;
+    t->next = NULL;
+    t->period = 0u;
+    t->active = 0u;
+}
+
+void SWTIMER_Start( swtimer_t *t, uint16_t delay, uint16_t period ){
+    SWTIMER_Stop( t );
+    if( delay == 0u )
+        delay = 1u;
+    t->period = period;
+    swtimer_Insert( t, delay );
+}
+
+void SWTIMER_Stop( swtimer_t *t ){
+    swtimer_t **pp;
+
+    if( !t->active )
+        return;
+    t->active = 0u;
+    pp = (t->slot == SWTIMER_SLOT_EXPIRED) ? &swtimer_expired
+                                           : &swtimer_wheel[t->slot];
+    for( ; *pp != NULL; pp = &(*pp)->next ){
+        if( *pp == t ){
+            *pp = t->next;
+            // the next one waits the turns of t too (delta list)
+            if( t->next != NULL && t->slot != SWTIMER_SLOT_EXPIRED )
+                t->next->rounds += t->rounds;
+            return;
+        }
+    }
+}
+
+void SWTIMER_Tick( void ){
+    swtimer_ticks++;
+}
+
+void SWTIMER_Process( void ){
+    while( swtimer_done != swtimer_ticks ){
+        swtimer_t *list, *t;
+
+        swtimer_done++;
+        swtimer_cursor = (swtimer_cursor + 1u) & SWTIMER_WHEEL_MASK;
+
+        // move the expired heads of the slot (no turns left) to the expired
+        // list, then one turn less for the rest: only the new head changes
+        // (no callback is called here, so the lists can not change)
+        list = swtimer_wheel[swtimer_cursor];
+        while( list != NULL && list->rounds == 0u ){
+            t = list;
+            list = t->next;
+            t->slot = SWTIMER_SLOT_EXPIRED;
+            t->next = swtimer_expired;
+            swtimer_expired = t;
+        }
+        if( list != NULL )
+            list->rounds--;
+        swtimer_wheel[swtimer_cursor] = list;
+
+        // call the callbacks, re-arm the periodic timers first so the
+        // callback can stop or restart its timer (or any other)
+        while( (t = swtimer_expired) != NULL ){
+            swtimer_expired = t->next;
+            t->active = 0u;
+            if( t->period )
+                swtimer_Insert( t, t->period );
+            if( t->callback != NULL )
+                t->callback( t );
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * File:   swtimer.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Software timers on a hashed timing wheel. One shot and periodic timers
+ * with an expiry callback, any amount of timers.
+ *  - SWTIMER_Tick is called from the tick ISR (Ej: TMR0_InterruptHandler),
+ *    it only counts the tick: constant cost.
+ *  - SWTIMER_Process is called from the main loop, it advances the wheel one
+ *    slot per elapsed tick (the timers are spread on SWTIMER_WHEEL_SIZE
+ *    slots by expiry time). Every slot is sorted by wheel turns, so a tick
+ *    only checks the head of the slot: constant cost plus the expired
+ *    timers, whatever the amount of timers. The callbacks run here, not on
+ *    the ISR.
+ *  - SWTIMER_Start and SWTIMER_Stop walk the list of one slot (sorted
+ *    insert and unlink): cost proportional to the timers of that slot.
+ *  The timer objects are owned by the caller (no dynamic memory).
+ *
+ * @Example
+ * <code>
+ *  static swtimer_t muxTimer;
+ *
+ *  static void muxRefresh( swtimer_t *t ){
+ *      SSD_Mux( &mySSD );
+ *  }
+ *
+ *  void main( void ){
+ *      ...
+ *      SWTIMER_Initialize( &muxTimer, muxRefresh );
+ *      SWTIMER_Start( &muxTimer, 5u, 5u );     // every 5 ticks
+ *      while( 1 ){
+ *          SWTIMER_Process();
+ *          ...
+ *      }
+ *  }
+ * </code>
+ */
+
+#ifndef SWTIMER_H
+#define	SWTIMER_H
+
+#include <stdint.h>
+
+/**
+ * Wheel slots (power of two). More slots: less timers visited per tick,
+ * more RAM (one pointer per slot).
+ **/
+#define SWTIMER_WHEEL_BITS  3u
+#define SWTIMER_WHEEL_SIZE  (1u << SWTIMER_WHEEL_BITS)
+
+/**
+ * Timer object (the fields are private)
+ **/
+typedef struct swtimer_s{
+    struct swtimer_s *next;                 // next timer of the slot
+    void (*callback)( struct swtimer_s *t );
+    uint16_t period;                        // ticks, 0: one shot
+    uint16_t rounds;                        // wheel turns before expire
+    uint8_t slot;                           // wheel slot
+    uint8_t active;
+} swtimer_t;
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    /**
+     * Initialize the timer (stopped) with the expiry callback
+     **/
+    void SWTIMER_Initialize( swtimer_t *t, void (*callback)( swtimer_t *t ) );
+
+    /**
+     * Start (or restart) the timer: expire after 'delay' ticks (>= 1), and
+     * then every 'period' ticks (0: one shot)
+     **/
+    void SWTIMER_Start( swtimer_t *t, uint16_t delay, uint16_t period );
+
+    /**
+     * Stop the timer (nothing is done if it is not running)
+     **/
+    void SWTIMER_Stop( swtimer_t *t );
+
+    /**
+     * Return 1 if the timer is running
+     **/
+    #define SWTIMER_IsActive( t )   ( (t)->active )
+
+    /**
+     * Count one tick. Call it from the tick ISR.
+     **/
+    void SWTIMER_Tick( void );
+
+    /**
+     * Advance the wheel with the elapsed ticks and call the callbacks of the
+     * expired timers. Call it from the main loop.
+     *  The ticks are counted on 8 bits (read by the main loop in one
+     * instruction, without disable the interrupts): call it at least once
+     * every 255 ticks, after a longer gap 256 ticks are lost.
+     *  The callback can start or stop its own timer, or start other timers.
+     **/
+    void SWTIMER_Process( void );
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SWTIMER_H */
@@ -0,0 +1,126 @@
+/*
+ * File:   trace.c
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description
+ *  Implementation of the event trace recorder (see trace.h).
+ */
+
+#include <stdint.h>
+#include "trace.h"
+#include "num2str.h"
+#include "critical.h"
+#include "profile.h"
+
+#if TRACE_ENABLE
+
+#define TRACE_MASK  (TRACE_SIZE - 1u)
+
+// power of two, up to 128 (uint8_t indexes)
+typedef char trace_size_check[((TRACE_SIZE & TRACE_MASK) == 0u &&
+                               TRACE_SIZE <= 128u) ? 1 : -1];
+
+/******************************************************************************
+ ************************** Section: Local Vars *******************************
+ ******************************************************************************/
+
+typedef struct{
+    uint8_t id;
+    uint8_t payload;
+    uint16_t time;
+} trace_record_t;
+
+static trace_record_t trace_buffer[TRACE_SIZE];
+static uint8_t trace_head;          // next record (free running)
+static uint8_t trace_count;         // stored records (<= TRACE_SIZE)
+static volatile uint8_t trace_frozen;
+
+/******************************************************************************
+ ************************ Section: Local Routines *****************************
+ ******************************************************************************/
+
+/**
+ * Put one character on the sink
+ **/
+#define trace_Put( sink, c )    (sink)->Put( (sink)->ctx, (char)(c) )
+
+/**
+ * Put x as hexadecimal with 'digits' digits and the separator sep
+ **/
+static void trace_PutHex( const num2str_sink_t *sink, uint16_t x,
+                          uint8_t digits, char sep ){
+    ulong2sink( x, 16u, digits, '0', sink );
+    trace_Put( sink, sep );
+}
+
+/******************************************************************************
+ ************************** Section: Trace APIs *******************************
+ ******************************************************************************/
+
+void TRACE_Record( uint8_t id, uint8_t payload ){
+    trace_record_t *r;
+
+    if( trace_frozen )
+        return;
+
+    // the ISR can record between the index update and the writes
+    CRITICAL_ENTER();
+    r = &trace_buffer[trace_head & TRACE_MASK];
+    trace_head++;
+    if( trace_count < TRACE_SIZE )
+        trace_count++;
+    r->id = id;
+    r->payload = payload;
+    r->time = PROFILE_Now();
+    CRITICAL_EXIT();
+}
+
+void TRACE_Trigger( void ){
+    trace_frozen = 1u;
+}
+
+uint8_t TRACE_IsTriggered( void ){
+    return trace_frozen;
+}
+
+void TRACE_Restart( void ){
+    CRITICAL_ENTER();
+    trace_head = 0u;
+    trace_count = 0u;
+    trace_frozen = 0u;
+    CRITICAL_EXIT();
+}
+
+void TRACE_Dump( const num2str_sink_t *sink, uint8_t format ){
+    uint8_t i = (uint8_t)(trace_head - trace_count);    // oldest record
+    uint8_t n = trace_count;
+    const char *s = "TRACE ";
+    const trace_record_t *r;
+
+    if( format == TRACE_DUMP_BINARY )
+        trace_Put( sink, n );
+    else{
+        while( *s )
+            trace_Put( sink, *s++ );
+        ulong2sink( n, 10u, 0u, ' ', sink );
+        trace_Put( sink, '\n' );
+    }
+
+    while( n-- ){
+        r = &trace_buffer[i & TRACE_MASK];
+        i++;
+        if( format == TRACE_DUMP_BINARY ){
+            trace_Put( sink, r->id );
+            trace_Put( sink, r->payload );
+            trace_Put( sink, (uint8_t)r->time );
+            trace_Put( sink, (uint8_t)(r->time >> 8) );
+        }
+        else{
+            trace_PutHex( sink, r->id, 2u, ' ' );
+            trace_PutHex( sink, r->payload, 2u, ' ' );
+            trace_PutHex( sink, r->time, 4u, '\n' );
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * File:   trace.h
+ * Author: Jose Guerra Carmenate
+ *
+ * @Description:
+ *  Event trace: TRACE_RECORD(id, payload) stores a 4 bytes record (event
+ * id, 1 byte payload and the 16 bits Timer1 time, see PROFILE_Now) on a RAM
+ * circular buffer. When the buffer is full the oldest record is replaced,
+ * so the buffer always holds the last TRACE_SIZE events.
+ *  The record is O(1) (no loops, no division) and can be used from the ISR
+ * and from the main code.
+ *  TRACE_Trigger freezes the buffer (Ej: when an error is detected), and
+ * TRACE_Dump sends it to a character sink (serial port, LCD, EEPROM, see
+ * EEPROM_SinkPut) from the main loop. The tool tools/trace_decode.py turns
+ * the dump into a timeline.
+ *  With TRACE_ENABLE = 0 (default) TRACE_RECORD expands to nothing.
+ *
+ *  The time stamps wrap around every 65536 Timer1 counts (13ms at 20MHz
+ * with 1:1 prescaler). The decoder unwraps them assuming that two
+ * consecutive events are never separated by more than that: use a Timer1
+ * prescaler if the events are sparse.
+ *
+ * @Example
+ * <code>
+ *  TRACE_RECORD( TRACE_ID_USER, state );
+ *  ...
+ *  if( error ){
+ *      TRACE_Trigger();
+ *      TRACE_Dump( &uartSink, TRACE_DUMP_TEXT );
+ *  }
+ * </code>
+ */
+
+#ifndef TRACE_H
+#define	TRACE_H
+
+#include <stdint.h>
+#include "num2str.h"
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE    0
+#endif
+
+/**
+ * Records on the buffer (power of two up to 128, 4 bytes of RAM per record)
+ **/
+#ifndef TRACE_SIZE
+#define TRACE_SIZE      16u
+#endif
+
+/**
+ * Events ids of the library, the application use TRACE_ID_USER and above
+ **/
+#define TRACE_ID_ISR        0x01u   // served interrupt, payload: ISR_SRC_xxx
+#define TRACE_ID_SPI_BYTE   0x02u   // SPI byte written, payload: the byte
+#define TRACE_ID_ADC_DONE   0x03u   // ADC conversion, payload: ADRESH
+#define TRACE_ID_DISPLAY    0x04u   // display refresh, payload: digit/line
+#define TRACE_ID_USER       0x10u
+
+/**
+ * Dump formats
+ *  - TEXT: "TRACE <n>" line and one "<id> <payload> <time>" line (hex)
+ *    per record, the oldest first.
+ *  - BINARY: records amount (1 byte) and the records, 4 bytes each: id,
+ *    payload, time low byte, time high byte.
+ **/
+#define TRACE_DUMP_TEXT     0u
+#define TRACE_DUMP_BINARY   1u
+
+#if TRACE_ENABLE
+#define TRACE_RECORD( id, payload )     TRACE_Record( (id), (payload) )
+#else
+#define TRACE_RECORD( id, payload )     ((void)0)
+#endif
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#if TRACE_ENABLE
+    /**
+     * Store one event (nothing is done while triggered)
+     **/
+    void TRACE_Record( uint8_t id, uint8_t payload );
+
+    /**
+     * Freeze the buffer: the next records are discarded
+     **/
+    void TRACE_Trigger( void );
+
+    /**
+     * Return 1 if the buffer is frozen
+     **/
+    uint8_t TRACE_IsTriggered( void );
+
+    /**
+     * Clear the buffer and start to record again
+     **/
+    void TRACE_Restart( void );
+
+    /**
+     * Send the records to sink on the given format (TRACE_DUMP_xxx). Call
+     * it after TRACE_Trigger, from the main loop.
+     **/
+    void TRACE_Dump( const num2str_sink_t *sink, uint8_t format );
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* TRACE_H */
@@ -29,22 +29,64 @@
 #define BIT_ToggleMask( var, mask )     ( (var) ^=  (mask) )
 #define BIT_GetBitStatus( var, bit ) 	(((var)>>(bit)) & 0x1u)
 
+/**
+ Single bit of an 8 bits var (SFR or uint8_t variable, bit 0 to 7)
+ 
+ The mask is 8 bits wide, so with a constant 'bit' and a 'var' with fixed
+ address XC8 compile them to one BSF/BCF instruction, that can not be 
+ interrupted (safe against ISRs). BIT_SetBit/BIT_ClearBit work on any width
+ but their mask is an int, use these ones for registers.
+ With a variable 'bit' or a pointer a shift loop and a read-modify-write 
+ sequence is generated (not atomic).
+ **/
+
+#define BIT_SetBit8( var, bit )         ( (var) |= (uint8_t)(1u<<(bit)) )
+#define BIT_ClearBit8( var, bit )       ( (var) &= (uint8_t)~(uint8_t)(1u<<(bit)) )
 
 /**
- Macros to extract the nibbles 
+ Macros for Bit Fields
+ 
+ A field is 'width' bits starting on bit 'pos' of var. 
+ With constant pos/width/mask the mask is computed by the compiler and var
+ is read once and written once (one masked write instead of a sequence of
+ |= and &=). When 'value' is also constant and var was just cleared use a 
+ plain assignment.
+ As on BIT_ClearMask, the mask must be as wide as var (Ej: 0x0F00ul for a
+ uint32_t var). BIT_ExtractField returns a uint8_t (width 8 at most).
  **/
-#define BYTE_GetNibble0to4(x) 		(uint8_t)( (x) & 0x0Fu )
-#define BYTE_GetNibble4to8(x) 		(uint8_t)( ((x)>>4) & 0x0Fu )
-#define BYTE_GetNibble8to12(x) 		(uint8_t)( ((x)>>8) & 0x0Fu )
-#define BYTE_GetNibble12to16(x) 	(uint8_t)( ((x)>>16) & 0x0Fu )
+
+#define BIT_FieldMask( pos, width )     ( ((1u<<(width)) - 1u) << (pos) )
+#define BIT_InsertMask( var, mask, value )                                  \
+        ( (var) = ((var) & ~(mask)) | ((value) & (mask)) )
+#define BIT_InsertField( var, pos, width, value )                           \
+        BIT_InsertMask( (var), BIT_FieldMask( (pos), (width) ), (value)<<(pos) )
+#define BIT_ExtractField( var, pos, width )                                 \
+        (uint8_t)( ((var)>>(pos)) & ((1u<<(width)) - 1u) )
+
 
 /**
- Macros to extract the Bytes
+ Macros to extract the nibbles (n = 0 is the less significant nibble)
  **/
-#define BYTE_GetByte0to8(x)    (uint8_t) ((x) & 0xFFu)
-#define BYTE_GetByte8to16(x)   (uint8_t) (((x)>>8) & 0xFFu)
-#define BYTE_GetByte16to28(x)  (uint8_t) (((x)>>16) & 0xFFu)
-#define BYTE_GetByte28to32(x)  (uint8_t) (((x)>>28) & 0xFFu)
+#define BYTE_GetNibble( x, n )      (uint8_t)( ((x)>>((n)*4u)) & 0x0Fu )
+
+#define BYTE_GetNibble0to4(x) 		BYTE_GetNibble( (x), 0u )
+#define BYTE_GetNibble4to8(x) 		BYTE_GetNibble( (x), 1u )
+#define BYTE_GetNibble8to12(x) 		BYTE_GetNibble( (x), 2u )
+#define BYTE_GetNibble12to16(x) 	BYTE_GetNibble( (x), 3u )
+
+/**
+ Macros to extract the Bytes (n = 0 is the less significant byte)
+ **/
+#define BYTE_GetByte( x, n )        (uint8_t)( ((x)>>((n)*8u)) & 0xFFu )
+
+#define BYTE_GetByte0to8(x)    BYTE_GetByte( (x), 0u )
+#define BYTE_GetByte8to16(x)   BYTE_GetByte( (x), 1u )
+#define BYTE_GetByte16to24(x)  BYTE_GetByte( (x), 2u )
+#define BYTE_GetByte24to32(x)  BYTE_GetByte( (x), 3u )
+
+// old names
+#define BYTE_GetByte16to28(x)  BYTE_GetByte16to24(x)
+#define BYTE_GetByte28to32(x)  BYTE_GetByte24to32(x)
 
 
 